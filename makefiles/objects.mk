@@ -4,5 +4,5 @@
 
 USER_OBJS :=
 
-LIBS := -lopencv_calib3d -lopencv_text -llept -ltesseract -lopencv_highgui -lopencv_imgcodecs -lopencv_imgproc -lopencv_ml -lopencv_objdetect -lopencv_photo -lopencv_shape -lopencv_stitching -lopencv_superres -lopencv_ts -lopencv_video -lopencv_videoio -lopencv_videostab -lopencv_adas -lopencv_bgsegm -lopencv_core -lopencv_features2d -lopencv_flann
+LIBS := -lopencv_calib3d -lopencv_text -llept -ltesseract -lopencv_highgui -lopencv_imgcodecs -lopencv_imgproc -lopencv_ml -lopencv_objdetect -lopencv_photo -lopencv_shape -lopencv_stitching -lopencv_superres -lopencv_ts -lopencv_video -lopencv_videoio -lopencv_videostab -lopencv_adas -lopencv_bgsegm -lopencv_core -lopencv_features2d -lopencv_flann -lpthread
 
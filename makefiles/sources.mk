@@ -13,6 +13,8 @@ CXX_SRCS :=
 C++_SRCS := 
 CC_SRCS := 
 OBJS := 
+BENCH_OBJS := 
+KERNELS_OBJS := 
 C++_DEPS := 
 C_DEPS := 
 CC_DEPS := 
@@ -29,5 +31,6 @@ src/preprocessing/addNoise \
 src/preprocessing/GaussianSPDenoise \
 src \
 src/borderPosition \
+src/bench \
 .metadata/.plugins/org.eclipse.cdt.make.core \
 
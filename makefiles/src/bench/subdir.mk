@@ -0,0 +1,30 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+# the benchmarks have their own main, so they are kept out of OBJS
+CPP_SRCS += \
+../src/bench/ocrus_bench.cpp \
+../src/bench/ocrus_kernels.cpp 
+
+BENCH_OBJS += \
+./src/bench/ocrus_bench.o 
+
+KERNELS_OBJS += \
+./src/bench/ocrus_kernels.o 
+
+CPP_DEPS += \
+./src/bench/ocrus_bench.d \
+./src/bench/ocrus_kernels.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/bench/%.o: ../src/bench/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -I/home/ubuntu/opencv/include -I/home/ubuntu/opencv/include/opencv -I/home/ubuntu/tesseract/include -I/home/ubuntu/leptonica/include -O2 -g -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
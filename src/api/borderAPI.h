@@ -7,17 +7,21 @@
 using namespace std;
 using namespace cv;
 
-static vector<Point2f> getBorder(Mat img, map<int, vector<Vec4i> >& lines){
+/*
+ * ctx is the state of the border detection, one per calling thread.
+ */
+static vector<Point2f> getBorder(BorderContext& ctx, Mat img, map<int, vector<Vec4i> >& lines){
 
 	SalientRec src;
-	Mat salientImg, seg;
+	SalientMap salientImg;
+	Mat seg;
 
 	src.salient(img, salientImg, seg);
 	vector<Point2f> result;
 
-	int res = getBorderPtOnSalient(salientImg, result, lines);
+	int res = getBorderPtOnSalient(ctx, salientImg, result, lines);
 	if (res == -1) {
-		res = getBorderPtOnRaw(img, salientImg, result, lines);
+		res = getBorderPtOnRaw(ctx, img, salientImg, result, lines);
 	}
 	if(res!=-1)
 		return result;
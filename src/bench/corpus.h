@@ -0,0 +1,179 @@
+/*
+ * corpus.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_BENCH_CORPUS_H_
+#define IMAGE_PROCESS_SRC_BENCH_CORPUS_H_
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "../preprocessing/addNoise/addnoise.h"
+
+using namespace std;
+using namespace cv;
+
+/*
+ * Synthetic name card photos for benchmarking: a card with a few lines of
+ * text is rendered, put in perspective on a random background, rotated and
+ * noised with AddNoise. Image i only depends on (seed, i), so two builds
+ * see exactly the same corpus.
+ */
+class SyntheticCorpus {
+public:
+	SyntheticCorpus(unsigned int seed, Size size = Size(1280, 960)) :
+			seed(seed), size(size) {
+	}
+
+	Mat image(int i) {
+		vector<Point2f> corners;
+		return image(i, corners);
+	}
+
+	/*
+	 * corners gets the 4 card corners in the returned image (tl, tr, br, bl).
+	 */
+	Mat image(int i, vector<Point2f>& corners) {
+		RNG rng(((uint64) seed << 32) + i + 1);
+		/*randn/randu in AddNoise use the thread's default generator*/
+		theRNG().state = rng.state;
+
+		Mat background(size, CV_8UC3, AddNoise::randomColor(rng));
+		Mat img;
+		AddNoise::addRandomBackground(background, img, rng, 10, 0.6, 0.4);
+
+		Mat card = renderCard(rng);
+		placeCard(card, img, rng, corners);
+
+		/*same draw as in rotateRandomAngle, to rotate the corners along*/
+		RNG angleRng = rng;
+		Mat rot = getRotationMatrix2D(Point(img.cols / 2, img.rows / 2),
+				angleRng.uniform(-45, 45), 1.0);
+		vector<Point2f> rotatedCorners;
+		transform(corners, rotatedCorners, rot);
+		corners = rotatedCorners;
+		Mat rotated;
+		AddNoise::rotateRandomAngle(img, rotated, rng);
+		img = rotated;
+
+		/*the noise functions take 8UC1, so they are applied per channel*/
+		vector<Mat> channels;
+		split(img, channels);
+		bool saltPepper = rng.uniform(0, 4) == 0;
+		for (unsigned int c = 0; c < channels.size(); c++) {
+			AddNoise::addGaussianNoise(channels[c], channels[c], 0.9, 0.1,
+					0, 40);
+			if (saltPepper)
+				AddNoise::addSaltPepperNoise(channels[c], channels[c], 10,
+						245);
+		}
+		merge(channels, img);
+		return img;
+	}
+
+	/*
+	 * Writes the first count images to dir/card_<i>.jpg.
+	 */
+	void save(const string& dir, int count) {
+		for (int i = 0; i < count; i++) {
+			char name[32];
+			snprintf(name, sizeof(name), "/card_%04d.jpg", i);
+			imwrite(dir + name, image(i));
+		}
+	}
+
+private:
+	static string pick(RNG& rng, const char* const * words, int n) {
+		return words[rng.uniform(0, n)];
+	}
+
+	static string digits(RNG& rng, int n) {
+		string s;
+		for (int i = 0; i < n; i++)
+			s += (char) ('0' + rng.uniform(0, 10));
+		return s;
+	}
+
+	Mat renderCard(RNG& rng) {
+		static const char* const firstNames[] = { "Reggie", "Akira", "Mei",
+				"Litton", "Sarah", "Kenji", "Wei", "Laura", "Hiroshi", "Anna" };
+		static const char* const familyNames[] = { "Chen", "Tanaka", "Wang",
+				"Smith", "Suzuki", "Li", "Brown", "Sato", "Zhang", "Miller" };
+		static const char* const careers[] = { "Manager", "Sales Director",
+				"Software Engineer", "Chief Executive Officer", "Consultant",
+				"Product Designer", "Account Executive" };
+		static const char* const companies[] = { "OCRus Inc.",
+				"Pacific Trading Co., Ltd.", "Blue River Systems",
+				"Northwind Consulting", "Sakura Electronics" };
+		static const char* const streets[] = { "Main Street", "Harbor Road",
+				"Sunset Blvd", "Chuo-ku", "Nanjing Road" };
+		static const int fonts[] = { FONT_HERSHEY_SIMPLEX, FONT_HERSHEY_DUPLEX,
+				FONT_HERSHEY_COMPLEX, FONT_HERSHEY_TRIPLEX };
+
+		int w = rng.uniform(620, 820);
+		int h = w * 55 / 91;
+		Scalar paper(rng.uniform(215, 256), rng.uniform(215, 256),
+				rng.uniform(215, 256));
+		Scalar ink(rng.uniform(0, 80), rng.uniform(0, 80), rng.uniform(0, 80));
+		Mat card(h, w, CV_8UC3, paper);
+
+		string first = pick(rng, firstNames, 10);
+		string family = pick(rng, familyNames, 10);
+		vector<string> lines;
+		lines.push_back(first + " " + family);
+		lines.push_back(pick(rng, careers, 7));
+		lines.push_back(pick(rng, companies, 5));
+		lines.push_back("T: +" + digits(rng, 2) + " " + digits(rng, 3) + "-"
+				+ digits(rng, 4) + "-" + digits(rng, 4));
+		lines.push_back(
+				"E: " + first + "." + family + "@example.com");
+		lines.push_back(
+				"A: " + digits(rng, 3) + " " + pick(rng, streets, 5));
+
+		int font = fonts[rng.uniform(0, 4)];
+		int x = w / 12;
+		int y = h / 5;
+		for (unsigned int i = 0; i < lines.size(); i++) {
+			double fontScale = i == 0 ? 1.3 : 0.75;
+			int thickness = i == 0 ? 2 : 1;
+			int baseline = 0;
+			Size textSize = getTextSize(lines[i], font, fontScale, thickness,
+					&baseline);
+			putText(card, lines[i], Point(x, y), font, fontScale, ink,
+					thickness, LINE_AA);
+			y += textSize.height + (i == 0 ? h / 8 : h / 16);
+		}
+		return card;
+	}
+
+	/*
+	 * Warps card onto img as a slightly skewed quadrangle around the center.
+	 */
+	void placeCard(Mat& card, Mat& img, RNG& rng, vector<Point2f>& corners) {
+		double scale = rng.uniform(0.55, 0.75) * img.cols / card.cols;
+		float cw = card.cols * scale / 2, ch = card.rows * scale / 2;
+		Point2f c(img.cols / 2 + rng.uniform(-40, 40),
+				img.rows / 2 + rng.uniform(-40, 40));
+		Point2f from[4] = { Point2f(0, 0), Point2f(card.cols, 0), Point2f(
+				card.cols, card.rows), Point2f(0, card.rows) };
+		Point2f to[4] = { Point2f(c.x - cw, c.y - ch),
+				Point2f(c.x + cw, c.y - ch), Point2f(c.x + cw, c.y + ch),
+				Point2f(c.x - cw, c.y + ch) };
+		for (int k = 0; k < 4; k++) {
+			to[k].x += rng.uniform(-0.08f, 0.08f) * cw;
+			to[k].y += rng.uniform(-0.08f, 0.08f) * ch;
+		}
+		corners.assign(to, to + 4);
+		Mat H = getPerspectiveTransform(from, to);
+		warpPerspective(card, img, H, img.size(), INTER_LINEAR,
+				BORDER_TRANSPARENT);
+	}
+
+	unsigned int seed;
+	Size size;
+};
+
+#endif /* IMAGE_PROCESS_SRC_BENCH_CORPUS_H_ */
@@ -0,0 +1,149 @@
+/*
+ * kernelBench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_BENCH_KERNELBENCH_H_
+#define IMAGE_PROCESS_SRC_BENCH_KERNELBENCH_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+
+using namespace std;
+
+/*
+ * Times single kernels on fixed inputs.
+ *
+ * Every kernel is run once to warm up, then repeated until both minReps runs
+ * and minMs milliseconds are reached. prepare() is called before every run
+ * and is not timed, it resets the inputs a kernel modifies in place.
+ * The median and the median absolute deviation are reported, they are much
+ * less sensitive to a noisy machine than the mean.
+ */
+class KernelBench {
+public:
+	typedef function<void()> Func;
+
+	struct Result {
+		string name, input;
+		int reps;
+		double minUs, medianUs, meanUs, p90Us, madUs;
+	};
+
+	KernelBench(int minReps = 20, int minMs = 500, int maxReps = 10000) :
+			minReps(minReps), minMs(minMs), maxReps(maxReps) {
+	}
+
+	/*
+	 * input describes the input size, it is copied to the report as is.
+	 */
+	void add(const string& name, const string& input, const Func& prepare,
+			const Func& run) {
+		Kernel k;
+		k.name = name;
+		k.input = input;
+		k.prepare = prepare;
+		k.run = run;
+		kernels.push_back(k);
+	}
+
+	/*
+	 * Runs the kernels whose name contains filter (all if empty).
+	 */
+	vector<Result> runAll(const string& filter) {
+		vector<Result> results;
+		for (unsigned int i = 0; i < kernels.size(); i++) {
+			if (!filter.empty() && kernels[i].name.find(filter) == string::npos)
+				continue;
+			results.push_back(measure(kernels[i]));
+		}
+		return results;
+	}
+
+	static void printTable(const vector<Result>& results, ostream& os) {
+		char line[256];
+		snprintf(line, sizeof(line), "%-28s %-16s %6s %11s %11s %11s %9s\n",
+				"kernel", "input", "reps", "median(us)", "min(us)", "p90(us)",
+				"mad(%)");
+		os << line;
+		for (unsigned int i = 0; i < results.size(); i++) {
+			const Result& r = results[i];
+			snprintf(line, sizeof(line),
+					"%-28s %-16s %6d %11.1f %11.1f %11.1f %9.2f\n",
+					r.name.c_str(), r.input.c_str(), r.reps, r.medianUs,
+					r.minUs, r.p90Us,
+					r.medianUs > 0 ? 100 * r.madUs / r.medianUs : 0.0);
+			os << line;
+		}
+	}
+
+	/*
+	 * One JSON object per line:
+	 * {"kernel":..,"input":..,"reps":..,"median_us":..,"min_us":..,
+	 * "mean_us":..,"p90_us":..,"mad_us":..}
+	 */
+	static void printJson(const vector<Result>& results, ostream& os) {
+		for (unsigned int i = 0; i < results.size(); i++) {
+			const Result& r = results[i];
+			os << "{\"kernel\":\"" << r.name << "\",\"input\":\"" << r.input
+					<< "\",\"reps\":" << r.reps << ",\"median_us\":"
+					<< r.medianUs << ",\"min_us\":" << r.minUs
+					<< ",\"mean_us\":" << r.meanUs << ",\"p90_us\":" << r.p90Us
+					<< ",\"mad_us\":" << r.madUs << "}" << endl;
+		}
+	}
+
+private:
+	struct Kernel {
+		string name, input;
+		Func prepare, run;
+	};
+
+	Result measure(Kernel& k) {
+		k.prepare();
+		k.run();
+
+		vector<double> us;
+		double totalUs = 0;
+		while ((int) us.size() < maxReps
+				&& ((int) us.size() < minReps || totalUs < minMs * 1000.0)) {
+			k.prepare();
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			k.run();
+			chrono::steady_clock::duration d = chrono::steady_clock::now()
+					- start;
+			double t = chrono::duration<double, micro>(d).count();
+			us.push_back(t);
+			totalUs += t;
+		}
+
+		Result r;
+		r.name = k.name;
+		r.input = k.input;
+		r.reps = us.size();
+		sort(us.begin(), us.end());
+		r.minUs = us[0];
+		r.medianUs = us[us.size() / 2];
+		r.meanUs = totalUs / us.size();
+		r.p90Us = us[(us.size() * 9) / 10];
+		vector<double> dev(us.size());
+		for (unsigned int i = 0; i < us.size(); i++)
+			dev[i] = fabs(us[i] - r.medianUs);
+		sort(dev.begin(), dev.end());
+		r.madUs = dev[dev.size() / 2];
+		return r;
+	}
+
+	int minReps, minMs, maxReps;
+	vector<Kernel> kernels;
+};
+
+#endif /* IMAGE_PROCESS_SRC_BENCH_KERNELBENCH_H_ */
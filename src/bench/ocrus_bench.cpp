@@ -0,0 +1,150 @@
+/*
+ * ocrus_bench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#include "../workflow/processor.h"
+#include "corpus.h"
+#include <sys/resource.h>
+
+using namespace cv;
+using namespace std;
+
+/*
+ * End-to-end benchmark over a synthetic corpus, runs offline.
+ *
+ * ocrus_bench [-n count] [-s seed] [-j workers] [-t ocrThreads] [-l lang] [-x]
+ *             [-k dir] [-T timing.json]
+ * -n number of images (default 50)
+ * -s corpus seed (default 1), same seed gives the same images
+ * -j images processed in parallel (default 1)
+ * -t OCR threads per image (default 1)
+ * -l OCR language (default eng)
+ * -x skip the OCR, only time the image processing
+ * -k also write the corpus to dir (must exist), to look at it or to feed it
+ *    to image_process
+ * -T write the per-stage timings as JSON
+ * The corpus is rendered and jpg encoded in memory before the clock starts,
+ * the images/s cover decoding and the pipeline only.
+ */
+
+/*
+ * Renders image i and keeps it as a jpg, like the files -k writes and
+ * image_process reads. The corpus is made before the timed run.
+ */
+static void generateImage(SyntheticCorpus& corpus, int i,
+		vector<uchar>& encoded) {
+	static StageId generateStage("bench/generate");
+	ScopedTimer generateTimer(generateStage);
+	imencode(".jpg", corpus.image(i), encoded);
+}
+
+static void benchImage(const vector<uchar>& encoded, int i, bool ocr,
+		const string& lang, int ocrThreads, atomic<int>& failed) {
+	ScopedTimer decodeTimer(Processor::DECODE_STAGE);
+	Mat img = imdecode(encoded, IMREAD_COLOR);
+	decodeTimer.stop();
+
+	try {
+		SalientRecLease src;
+		vector<Point2f> corners;
+		vector<Mat> mats = Processor::process_image_main(img, *src, corners);
+		if (ocr)
+			Processor::ocrMats(mats, lang, ocrThreads);
+	} catch (cv::Exception& e) {
+		cerr << "image " << i << " failed: " << e.what() << endl;
+		failed++;
+	}
+}
+
+static void usage() {
+	cerr << "ocrus_bench [-n count] [-s seed] [-j workers] [-t ocrThreads]"
+			" [-l lang] [-x] [-k dir] [-T timing.json]" << endl;
+}
+
+int main(int argc, char** argv) {
+	int count = 50, threads = 1, ocrThreads = 1;
+	unsigned int seed = 1;
+	bool ocr = true;
+	string lang = "eng", keepDir, timingPath;
+	int ch;
+	while ((ch = getopt(argc, argv, "n:s:j:t:l:xk:T:")) != -1) {
+		switch (ch) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'j':
+			threads = atoi(optarg);
+			break;
+		case 't':
+			ocrThreads = atoi(optarg);
+			break;
+		case 'l':
+			lang = optarg;
+			break;
+		case 'x':
+			ocr = false;
+			break;
+		case 'k':
+			keepDir = optarg;
+			break;
+		case 'T':
+			timingPath = optarg;
+			break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+	if (count <= 0 || threads <= 0 || ocrThreads <= 0) {
+		usage();
+		return 1;
+	}
+
+	SyntheticCorpus corpus(seed);
+	if (!keepDir.empty())
+		corpus.save(keepDir, count);
+
+	ArtifactWriter::instance().setPolicy("none");
+	WorkStealingPool pool(threads);
+	if (ocr) {
+		OCREnginePool::instance().setMaxSize(pool.size() * ocrThreads);
+		OCREnginePool::instance().warmUp(lang, pool.size() * ocrThreads);
+	}
+
+	vector<vector<uchar> > encoded(count);
+	for (int i = 0; i < count; i++) {
+		pool.submit(bind(generateImage, ref(corpus), i, ref(encoded[i])));
+	}
+	pool.run();
+
+	atomic<int> failed(0);
+	for (int i = 0; i < count; i++) {
+		pool.submit(
+				bind(benchImage, cref(encoded[i]), i, ocr, cref(lang),
+						ocrThreads, ref(failed)));
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	pool.run();
+	double seconds = chrono::duration_cast<chrono::duration<double> >(
+			chrono::steady_clock::now() - start).count();
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+
+	cout << endl << "images: " << count << " (seed " << seed << ", "
+			<< failed << " failed), workers: " << pool.size()
+			<< ", ocr threads: " << (ocr ? ocrThreads : 0) << endl;
+	cout << "wall time: " << seconds << " s, " << count / seconds
+			<< " images/s (jpg decode included, corpus generation not)"
+			<< endl;
+	cout << "peak RSS: " << ru.ru_maxrss / 1024 << " MB" << endl << endl;
+	StageStats::instance().printTable(cout);
+	if (!timingPath.empty())
+		StageStats::instance().dumpJson(timingPath);
+	return failed > 0 ? 2 : 0;
+}
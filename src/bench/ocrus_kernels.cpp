@@ -0,0 +1,382 @@
+/*
+ * ocrus_kernels.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#include <cfloat>
+#include "../workflow/processor.h"
+#include "../salientRecognition/cut.h"
+#include "corpus.h"
+#include "kernelBench.h"
+
+using namespace cv;
+using namespace std;
+
+/*
+ * Microbenchmarks of the hot loops, on inputs derived from one image of the
+ * synthetic corpus at the sizes the workflow uses.
+ *
+ * ocrus_kernels [-s seed] [-i image] [-f filter] [-r minReps] [-m minMs]
+ *               [-o results.jsonl] [-v]
+ * -s, -i pick the corpus image the inputs are made from (default 1, 0)
+ * -f only run the kernels whose name contains filter
+ * -r, -m repeat each kernel at least minReps times and minMs milliseconds
+ *    (default 20, 500)
+ * -o write one JSON line per kernel, to compare two builds
+ * -v keep what the kernels print on stdout (dropped by default)
+ *
+ * Unless filtered out, the float densities of GetMixture are also checked
+ * against CmGMM_::P() in double on every pixel, and every refineOnce() of
+ * CmSalCut against a flow computed without the reused search trees. The
+ * exit status is 1 if the densities differ by more than GMM_TOLERANCE or
+ * a pixel changes segment.
+ */
+
+/*
+ * computeStrokeWidth is protected, it is only needed here.
+ */
+class StrokeWidthKernel: public RobustTextDetection {
+public:
+	StrokeWidthKernel(RobustTextParam& param) :
+			RobustTextDetection(param) {
+	}
+	using RobustTextDetection::computeStrokeWidth;
+};
+
+struct KernelInputs {
+	/*salient*/
+	Mat scaled, scaled3f, regionIdx, colorIdx, colors, colorCount;
+	Mat sal1f, components, mixture;
+	Ptr<CmSalCut> salCut;
+	int regNum;
+	RegionTable regions;
+	Mat regionColor, regionScore;
+	Mat_<float> colorDist;
+
+	/*text and preprocessing*/
+	Mat grey, binary, dist, strokeWidth;
+
+	/*border*/
+	Mat tsrc, tslt, edges;
+	vector<Point> quad;
+	vector<vector<Point2f> > cross;
+	map<int, vector<Vec4i> > lineMap;
+	BorderContext border;
+
+	Mat out;
+	double sink;
+};
+
+/*relative error of the float GMM densities*/
+const double GMM_TOLERANCE = 1e-3;
+const int SALCUT_ITERATIONS = 5;
+
+static string sizeOf(const Mat& m) {
+	ostringstream os;
+	os << m.cols << "x" << m.rows;
+	return os.str();
+}
+
+static void prepareInputs(KernelInputs& in, Mat& img,
+		const vector<Point2f>& corners) {
+	Pyramid pyramid(img);
+	in.scaled = pyramid.scale();
+	in.scaled.convertTo(in.scaled3f, CV_32FC3, 1.0 / 255);
+
+	/*a soft card mask stands in for the saliency map CmSalCut starts from*/
+	double ratio = in.scaled.cols / (double) img.cols;
+	vector<Point> card;
+	for (unsigned int k = 0; k < corners.size(); k++)
+		card.push_back(corners[k] * ratio);
+	in.sal1f = Mat::zeros(in.scaled.size(), CV_32F);
+	fillConvexPoly(in.sal1f, card, Scalar(1));
+	GaussianBlur(in.sal1f, in.sal1f, Size(31, 31), 0);
+
+	/*same steps as getRC, to get the regions RegionContrast works on*/
+	GraphSegmentation segmentation(1.2, 200, 500);
+	in.regNum = segmentation.segment_image(in.scaled, in.regionIdx);
+	Quantizer quantizer;
+	quantizer.Quantize(in.scaled3f, in.colorIdx, in.colors, in.colorCount);
+	cvtColor(in.colors, in.regionColor, CV_BGR2Lab);
+	in.regions.reset(in.regNum);
+	RegionContrastSalient rcs;
+	rcs.BuildRegions(in.regionIdx, in.regions, in.colorIdx,
+			in.regionColor.cols);
+	in.colorDist = pairwiseColorDist(in.regionColor);
+
+	Mat grey;
+	cvtColor(img, grey, CV_BGR2GRAY);
+	resize(grey, in.grey, Size(640, 480));
+	Binarize::NiblackSauvolaWolfJolion(in.grey, in.binary, WOLFJOLION,
+			in.grey.cols / 3.5, in.grey.rows / 3.5, 0.5, 128);
+	in.binary = 255 - in.binary;
+	distanceTransform(in.binary, in.dist, CV_DIST_L2, 3);
+	in.dist.convertTo(in.dist, CV_32SC1);
+	RobustTextParam param;
+	StrokeWidthKernel detector(param);
+	in.strokeWidth = detector.computeStrokeWidth(in.dist);
+
+	/*same as getBorderPtOnRaw and the edge step of process()*/
+	double scale = myNormalSize(img, in.tsrc, CV_32S);
+	Mat mask = Mat::zeros(img.size(), CV_32F);
+	vector<Point> quad;
+	for (unsigned int k = 0; k < corners.size(); k++) {
+		quad.push_back(corners[k]);
+		in.quad.push_back(corners[k] * scale);
+	}
+	fillConvexPoly(mask, quad, Scalar(1));
+	myNormalSize(mask, in.tslt, CV_32F);
+
+	Mat bw, gx, gy, agx, agy, g;
+	cvtColor(in.tsrc, bw, CV_BGR2GRAY);
+	Sobel(bw, gx, CV_16S, 1, 0);
+	convertScaleAbs(gx, agx);
+	Sobel(bw, gy, CV_16S, 0, 1);
+	convertScaleAbs(gy, agy);
+	addWeighted(agx, 1, agy, 1, 0, g);
+	threshold(g, in.edges, 180.0, 255, CV_THRESH_TOZERO);
+}
+
+static void nothing(KernelInputs& in) {
+}
+
+static void quantizeKernel(KernelInputs& in) {
+	Quantizer quantizer;
+	quantizer.Quantize(in.scaled3f, in.colorIdx, in.colors, in.colorCount);
+}
+
+static void segmentKernel(KernelInputs& in) {
+	GraphSegmentation segmentation(1.2, 200, 500);
+	segmentation.segment_image(in.scaled, in.out);
+}
+
+/*
+ * The foreground GMM of CmSalCut, fitted on the card and evaluated on the
+ * whole image.
+ */
+static void gmmKernel(KernelInputs& in) {
+	CmGMM gmm(5);
+	gmm.BuildGMMs(in.scaled3f, in.components, in.sal1f);
+	gmm.GetMixture(in.scaled3f, in.mixture);
+}
+
+/*
+ * A CmSalCut started from the card mask, like from a saliency map. The
+ * first refineOnce() builds the graph, the others reuse it.
+ */
+static void resetSalCut(KernelInputs& in) {
+	in.salCut = Ptr<CmSalCut>(new CmSalCut(in.scaled3f));
+	in.salCut->initialize(in.sal1f, 0.2f, 0.9f);
+	in.salCut->fitGMMs();
+}
+
+static void salCutKernel(KernelInputs& in) {
+	for (int i = 0; i < SALCUT_ITERATIONS; i++)
+		in.salCut->refineOnce();
+}
+
+static void regionContrastKernel(KernelInputs& in) {
+	RegionContrastSalient rcs;
+	rcs.RegionContrast(in.regions, in.regionColor, in.regionScore,
+			in.scaled.rows * in.scaled.cols, 0, in.colorDist);
+}
+
+static void binarizeKernel(KernelInputs& in) {
+	Binarize::NiblackSauvolaWolfJolion(in.grey, in.out, WOLFJOLION,
+			in.grey.cols / 3.5, in.grey.rows / 3.5, 0.5, 128);
+}
+
+static void connectedComponentKernel(KernelInputs& in) {
+	ConnectedComponent cc(10000, 8);
+	in.out = cc.apply(in.strokeWidth);
+}
+
+static void twoPassKernel(KernelInputs& in) {
+	CCA::labelByTwoPass(in.binary, in.out);
+}
+
+static void strokeWidthKernel(KernelInputs& in) {
+	RobustTextParam param;
+	StrokeWidthKernel detector(param);
+	in.out = detector.computeStrokeWidth(in.dist);
+}
+
+/*
+ * The 4 card borders, as they are checked for every quadrangle candidate.
+ */
+static void cardLinesKernel(KernelInputs& in) {
+	for (unsigned int k = 0; k < in.quad.size(); k++) {
+		double linkScore = 0, linkSpace = 0;
+		isLine(in.edges, linkScore, linkSpace, in.quad[k],
+				in.quad[(k + 1) % in.quad.size()], 2, 1, 1, false);
+		in.sink += linkScore + linkSpace;
+	}
+}
+
+static void resetBorder(KernelInputs& in) {
+	in.cross.clear();
+	in.lineMap.clear();
+	in.border.doubt = true;
+	in.border.lighting = 180.0;
+	in.border.curphase = 0;
+}
+
+static void borderProcessKernel(KernelInputs& in) {
+	process(in.border, in.tsrc, in.tslt, in.cross, false, false, in.lineMap);
+}
+
+/*
+ * Largest relative difference between the float densities of GetMixture
+ * and P(), on the pixels where P() is a normal float. Returns false if it
+ * is over GMM_TOLERANCE.
+ */
+static bool checkGMM(KernelInputs& in, ostream& os) {
+	CmGMM gmm(5);
+	gmm.BuildGMMs(in.scaled3f, in.components, in.sal1f);
+	gmm.GetMixture(in.scaled3f, in.mixture);
+	double maxErr = 0;
+	int tiny = 0;
+	for (int y = 0; y < in.scaled3f.rows; y++) {
+		const Vec3f* sample = in.scaled3f.ptr<Vec3f>(y);
+		const float* mixture = in.mixture.ptr<float>(y);
+		for (int x = 0; x < in.scaled3f.cols; x++) {
+			float p = gmm.P(sample[x]);
+			if (p < FLT_MIN) {
+				tiny++;
+				continue;
+			}
+			maxErr = max(maxErr, fabs(mixture[x] - p) / (double) p);
+		}
+	}
+	char line[256];
+	snprintf(line, sizeof(line),
+			"salient/gmm check: %d gaussians, max relative error %.2e"
+					" (%d pixels below FLT_MIN skipped)\n", gmm.K(), maxErr,
+			tiny);
+	os << line;
+	return maxErr <= GMM_TOLERANCE;
+}
+
+/*
+ * Pixels whose segment differs between the reused search trees of
+ * refineOnce() and maxflow(false), over SALCUT_ITERATIONS iterations.
+ * Returns false if there is any.
+ */
+static bool checkSalCut(KernelInputs& in, ostream& os) {
+	resetSalCut(in);
+	int changed = 0;
+	for (int i = 0; i < SALCUT_ITERATIONS; i++) {
+		in.salCut->refineOnce();
+		changed += in.salCut->checkReuse();
+	}
+	char line[256];
+	snprintf(line, sizeof(line),
+			"salient/salcut check: %d iterations, %d pixels differ from"
+					" maxflow(false)\n", SALCUT_ITERATIONS, changed);
+	os << line;
+	return changed == 0;
+}
+
+static void usage() {
+	cerr << "ocrus_kernels [-s seed] [-i image] [-f filter] [-r minReps]"
+			" [-m minMs] [-o results.jsonl] [-v]" << endl;
+}
+
+int main(int argc, char** argv) {
+	unsigned int seed = 1;
+	int image = 0, minReps = 20, minMs = 500;
+	bool verbose = false;
+	string filter, jsonPath;
+	int ch;
+	while ((ch = getopt(argc, argv, "s:i:f:r:m:o:v")) != -1) {
+		switch (ch) {
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'i':
+			image = atoi(optarg);
+			break;
+		case 'f':
+			filter = optarg;
+			break;
+		case 'r':
+			minReps = atoi(optarg);
+			break;
+		case 'm':
+			minMs = atoi(optarg);
+			break;
+		case 'o':
+			jsonPath = optarg;
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	SyntheticCorpus corpus(seed);
+	vector<Point2f> corners;
+	Mat img = corpus.image(image, corners);
+
+	/*the kernels print debug lines on cout, keep them out of the report*/
+	ofstream devNull("/dev/null");
+	streambuf* coutBuf = cout.rdbuf();
+	if (!verbose)
+		cout.rdbuf(devNull.rdbuf());
+
+	KernelInputs in;
+	in.sink = 0;
+	prepareInputs(in, img, corners);
+
+	KernelBench bench(minReps, minMs);
+	KernelBench::Func none = bind(nothing, ref(in));
+	bench.add("salient/quantize", sizeOf(in.scaled3f), none,
+			bind(quantizeKernel, ref(in)));
+	bench.add("salient/segment", sizeOf(in.scaled), none,
+			bind(segmentKernel, ref(in)));
+	ostringstream regions;
+	regions << in.regNum << " regions";
+	bench.add("salient/regionContrast", regions.str(), none,
+			bind(regionContrastKernel, ref(in)));
+	bench.add("salient/gmm", sizeOf(in.scaled3f), none,
+			bind(gmmKernel, ref(in)));
+	bench.add("salient/salcut", sizeOf(in.scaled3f),
+			bind(resetSalCut, ref(in)), bind(salCutKernel, ref(in)));
+	bench.add("preprocess/binarize", sizeOf(in.grey), none,
+			bind(binarizeKernel, ref(in)));
+	bench.add("text/connectedComponent", sizeOf(in.strokeWidth), none,
+			bind(connectedComponentKernel, ref(in)));
+	bench.add("cca/labelByTwoPass", sizeOf(in.binary), none,
+			bind(twoPassKernel, ref(in)));
+	bench.add("text/strokeWidth", sizeOf(in.dist), none,
+			bind(strokeWidthKernel, ref(in)));
+	bench.add("border/isLine", sizeOf(in.edges), none,
+			bind(cardLinesKernel, ref(in)));
+	bench.add("border/process", sizeOf(in.tsrc), bind(resetBorder, ref(in)),
+			bind(borderProcessKernel, ref(in)));
+
+	vector<KernelBench::Result> results = bench.runAll(filter);
+	cout.rdbuf(coutBuf);
+
+	KernelBench::printTable(results, cout);
+	bool gmmOk = true;
+	if (filter.empty() || string("salient/gmm").find(filter) != string::npos)
+		gmmOk = checkGMM(in, cout);
+	bool salCutOk = true;
+	if (filter.empty() || string("salient/salcut").find(filter) != string::npos)
+		salCutOk = checkSalCut(in, cout);
+	if (!jsonPath.empty()) {
+		ofstream json(jsonPath.c_str());
+		if (!json) {
+			cerr << "Can't write " << jsonPath << endl;
+			return 1;
+		}
+		KernelBench::printJson(results, json);
+	}
+	return gmmOk && salCutOk ? 0 : 1;
+}
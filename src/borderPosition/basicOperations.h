@@ -116,18 +116,29 @@ double dist(cv::Point2d p1, cv::Point2d p2) {
 	return sqrt((p1.x - p2.x) * (p1.x - p2.x) + (p1.y - p2.y) * (p1.y - p2.y));
 }
 
-double scale = 1.0;
+//ratio that brings the longest side of sz to 500
+double normalRatio(Size sz) {
+	return sz.width > sz.height ?
+			(sz.width > 500 ? 500.0 / sz.width : 1) :
+			(sz.height > 500 ? 500.0 / sz.height : 1);
+}
 
-void myNormalSize(Mat& src, Mat& tsrc, int type) {
+//returns the scale of tsrc to src
+double myNormalSize(Mat& src, Mat& tsrc, int type) {
 
-	double bili =
-			src.cols > src.rows ?
-					(src.cols > 500 ? 500.0 / src.cols : 1) :
-					(src.rows > 500 ? 500.0 / src.rows : 1);
+	double bili = normalRatio(src.size());
 	Size sz = Size(src.cols * bili, src.rows * bili);
 	tsrc = Mat(sz, type);
 	cv::resize(src, tsrc, sz);
-	scale = bili;
+	return bili;
+}
+
+//same as myNormalSize of slt.full() up to float rounding, see SalientMap::resized
+double myNormalSize(const SalientMap& slt, Mat& tslt, int type) {
+	Size full = slt.size();
+	double bili = normalRatio(full);
+	tslt = slt.resized(Size(full.width * bili, full.height * bili));
+	return bili;
 }
 
 //whether two lines have same direction
@@ -0,0 +1,94 @@
+/*
+ * borderContext.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_BORDERPOSITION_BORDERCONTEXT_H_
+#define IMAGE_PROCESS_SRC_BORDERPOSITION_BORDERCONTEXT_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+
+using namespace cv;
+using namespace std;
+
+/*
+ * Everything one border detection writes: the edges and the lines of the
+ * running process(), the scores of the candidates of each lighting phase
+ * and the ranks the getBorder*OnRaw entry points pick the result with.
+ * Each thread detecting borders needs its own context, two contexts never
+ * share anything.
+ */
+struct BorderContext {
+	BorderContext() :
+			finalines(4), lighting(110.0), doubt(true), curphase(0) {
+		memset(scoreCur, 0, sizeof(scoreCur));
+	}
+
+	//edges of process()
+	Mat grad_x, grad_y, abs_grad_x, abs_grad_y, grad;
+
+	//lines of process(), by decreasing score. The storage is kept from
+	//one call to the next, one block for all the lines
+	vector<CvLinePolar2> lines;
+	//the 4 lines of the candidate being made
+	vector<Vec4i> finalines;
+
+	double lighting; //edge threshold of the phase
+	bool doubt; //whether to try the next phase
+	//the salient image of a binary process(), for doubtShape()
+	BorderCoverage coverage;
+
+	//candidates of the 3 phases, scoreCur[curphase] of them so far
+	int curphase;
+	int scoreCur[3];
+	int lineScore[3][30];
+	int anglScore[3][30];
+	int spaceScore[3][30];
+	int areaScore[3][30];
+
+	//scores of the candidates of all the phases, and their ranks
+	vector<int> tLineScore;
+	vector<double> tAnglScore;
+	vector<int> tAreaScore;
+	vector<double> tSpaceScore;
+	int topRank[90];
+	int finalRank[30];
+	int spaceRank[30];
+	int angleRank[30];
+	int spaceRankDic[30];
+	int angleRankDic[30];
+};
+
+/*
+ * Strict order for std::stable_sort from a qsort style comparison of two
+ * indices of ctx.
+ */
+class BorderIndexLess {
+public:
+	typedef int (*Compare)(const BorderContext&, int, int);
+
+	BorderIndexLess(const BorderContext& ctx, Compare compare) :
+			ctx(&ctx), compare(compare) {
+	}
+
+	bool operator()(int a, int b) const {
+		return compare(*ctx, a, b) < 0;
+	}
+
+private:
+	const BorderContext* ctx;
+	Compare compare;
+};
+
+//sorts the first n indices of rank by compare, equal ones keep their order
+void sortRank(const BorderContext& ctx, int* rank, int n,
+		BorderIndexLess::Compare compare) {
+	stable_sort(rank, rank + n, BorderIndexLess(ctx, compare));
+}
+
+#endif /* IMAGE_PROCESS_SRC_BORDERPOSITION_BORDERCONTEXT_H_ */
@@ -7,6 +7,8 @@ typedef struct CvLinePolar2 {
 	float angle;
 	float votes;
 	float score;
+	double cosA, sinA; //of angle
+	cv::Vec4i seg; //the Hough segment the line was first found on
 } CvLinePolar2;
 
 typedef struct OppositeLines {
@@ -18,25 +20,12 @@ typedef struct Quadrangle {
 	cv::Point2f a, b, c, d;
 } Quadrangle;
 
-int THRESHOLD[2] = { 2, 7 };
-int SIZE[2] = { 3, 7 };
-int RUN[4] = { 1, 2, 2, 1 };
-int VOTERATE = 2;
-double OPPOANG = 1.0 / 4;//1.0/6
-int THRESHSCALE = 40; //210;
-int MAXLINK = 20;
-
-CvSeq* lines = 0;
-double lighting = 110.0;
-cv::Point2f center(0, 0);
-
-cv::Mat grad_x, grad_y, grad_x0, grad_y0;
-cv::Mat abs_grad_x, abs_grad_y, abs_grad_x0, abs_grad_y0;
-cv::Mat grad, grad0;
-std::vector<cv::Vec4i> finalines(4);
-
-int lineSorted[5000];
-
-vector<Vec4i> lines1;
+const int THRESHOLD[2] = { 2, 7 };
+const int SIZE[2] = { 3, 7 };
+const int RUN[4] = { 1, 2, 2, 1 };
+const int VOTERATE = 2;
+const double OPPOANG = 1.0 / 4;//1.0/6
+const int THRESHSCALE = 40; //210;
+const int MAXLINK = 10; //20;
 
 #endif
@@ -22,24 +22,17 @@ bool hasPixel(cv::Mat& mat, int thresh) {
 	return false;
 }
 
-bool nosimilar(CvLinePolar2 line, CvSeq* seq) {
-	for (int i = 0; i < seq->total; i++) {
-		CvLinePolar2* line2 = (CvLinePolar2*) cvGetSeqElem(seq, i);
+//if a line of lines is like line, keeps the better of the two in lines
+bool nosimilar(const CvLinePolar2& line, vector<CvLinePolar2>& lines) {
+	for (unsigned int i = 0; i < lines.size(); i++) {
+		CvLinePolar2* line2 = &lines[i];
 		if (fabs(line2->angle - line.angle) < CV_PI / 36
 				&& fabs(line2->rho - line.rho) < 5) {
 			//cout<<"found similar "<<line.score<<" "<<line2->score<<endl;
 			if (line.score > line2->score) {
-				line2->score = line.score;
-				line2->x1 = line.x1;
-				line2->y1 = line.y1;
-				line2->x2 = line.x2;
-				line2->y2 = line.y2;
-				line2->angle = line.angle;
-				line2->rho = line.rho;
-				line2->votes = line.votes;
-				CvLinePolar2* line3 = (CvLinePolar2*) cvGetSeqElem(lines, i);
-
-				//cout<<"score change "<<line3->score<<endl;
+				cv::Vec4i seg = line2->seg;
+				*line2 = line;
+				line2->seg = seg;
 			}
 			return false;
 		}
@@ -133,7 +126,6 @@ bool isLine(cv::Mat& mat, double& linkScore, double& linkSpace, cv::Point pt1,
 	maxTb = max(maxTb, tb);
 	//cout<<"grad "<<maxLr<<" "<<maxTb<<endl;
 
-	MAXLINK = 10;
 	if (mode <= 2 && maxLink >= MAXLINK) {
 		//if (debug) std::cout<<"true1 "<<maxLink<<std::endl;
 		linkScore = maxLink;
@@ -179,36 +171,30 @@ bool isHoriLine(double ang){
 	return false;
 }
 
-int compareLineScore(const void * a, const void * b) {
-	int ai = *(int*) a;
-	int bi = *(int*) b;
-	CvLinePolar2* l1 = (CvLinePolar2*) cvGetSeqElem(lines, ai);
-	CvLinePolar2* l2 = (CvLinePolar2*) cvGetSeqElem(lines, bi);
-	return -(l1->score - l2->score);
+//by decreasing score, lines closer than 1 are equal
+bool lineScoreGreater(const CvLinePolar2& l1, const CvLinePolar2& l2) {
+	return (int) -(l1.score - l2.score) < 0;
 }
 
-void sortLines(CvSeq* lines) {
-
-	for (int i = 0; i < min(5000, lines->total); i++) {
-		lineSorted[i] = i;
-	}
-
-	qsort(lineSorted, min(5000, lines->total), sizeof(int), compareLineScore);
+void sortLines(vector<CvLinePolar2>& lines) {
+	stable_sort(lines.begin(), lines.end(), lineScoreGreater);
 }
 
 
-CvSeq*
-convertXYLineToPolar(std::vector<cv::Vec4i> lines0, CvMemStorage* storage,
+/*
+ * Fills ctx.lines with the lines of the segments lines0 that are on edges
+ * of pic1, by decreasing score.
+ */
+void
+convertXYLineToPolar(BorderContext& ctx, std::vector<cv::Vec4i> lines0,
 		cv::Mat pic1, map<int, set<int> >& lineMap) {
 	int count = 0;
-	int lineType = CV_32FC(8);
-	int elemSize = sizeof(float) * 8;
 
-	lines1.clear();
-	lines = cvCreateSeq(lineType, sizeof(CvSeq), elemSize, storage);
-	int recMaxLink = MAXLINK;
+	vector<CvLinePolar2>& lines = ctx.lines;
+	lines.clear();
 	for (int i = 0; i < lines0.size(); i++) {
 		CvLinePolar2 line;
+		line.seg = lines0[i];
 		line.x1 = lines0[i][0];
 		line.y1 = lines0[i][1];
 		line.x2 = lines0[i][2];
@@ -237,7 +223,6 @@ convertXYLineToPolar(std::vector<cv::Vec4i> lines0, CvMemStorage* storage,
 
 		}
 
-		MAXLINK = 10;	//20;
 		double linkScore = 0.0;
 		double linkSpace = 0.0;
 		if ((isHoriLine(line.angle)||isVertLine(line.angle))&&isLine(pic1, linkScore, linkSpace,
@@ -250,23 +235,23 @@ convertXYLineToPolar(std::vector<cv::Vec4i> lines0, CvMemStorage* storage,
 							(line.x1 - line.x2) * (line.x1 - line.x2)
 									+ (line.y1 - line.y2) * (line.y1 - line.y2))
 							/ 5;
+			line.cosA = cos(line.angle);
+			line.sinA = sin(line.angle);
 			if (nosimilar(line, lines)) {
-				lines1.push_back(lines0[i]);
-				cvSeqPush(lines, &line);
-				//cout<<"lines increase "<<lines->total<<endl;
+				lines.push_back(line);
+				//cout<<"lines increase "<<lines.size()<<endl;
 			}
 		}
 	}
-	MAXLINK = recMaxLink;
 	sortLines(lines);
 
-	for(int i=0;i<lines->total;i++){
-		CvLinePolar2* line1 = (CvLinePolar2*) cvGetSeqElem(lines, i);
+	for(int i=0;i<lines.size();i++){
+		CvLinePolar2* line1 = &lines[i];
 		if(lineMap.find(i)==lineMap.end())
 			lineMap[i] = set<int>();
 
-		for(int j=i+1;j<lines->total;j++){
-			CvLinePolar2* line2 = (CvLinePolar2*) cvGetSeqElem(lines, j);
+		for(int j=i+1;j<lines.size();j++){
+			CvLinePolar2* line2 = &lines[j];
 			if(lineMap.find(j)==lineMap.end())
 				lineMap[j] = set<int>();
 
@@ -276,15 +261,13 @@ convertXYLineToPolar(std::vector<cv::Vec4i> lines0, CvMemStorage* storage,
 			}
 		}
 	}
-
-	return lines;
 }
 
-Vec4i polarToPoints(CvLinePolar2* polar){
+Vec4i polarToPoints(const CvLinePolar2* polar){
 	Vec4i res;
-	float rho = polar->rho, theta = polar->angle;
+	float rho = polar->rho;
 
-	double a = cos(theta), b = sin(theta);
+	double a = polar->cosA, b = polar->sinA;
 	double x0 = a * rho, y0 = b * rho;
 	res[0] = cvRound(x0 + 1000 * (-b));
 	res[1] = cvRound(y0 + 1000 * (a));
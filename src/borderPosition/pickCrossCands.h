@@ -1,25 +1,25 @@
 #ifndef BORDER_PICK_CROSSCANDS_H
 #define BORDER_PICK_CROSSCANDS_H
 
-void makeFinalLine(int index, CvLinePolar2* line, vector<double>& lineAngles){
+void makeFinalLine(BorderContext& ctx, int index, CvLinePolar2* line, vector<double>& lineAngles){
 
-	float rho = line->rho, theta = line->angle;
+	float rho = line->rho;
 	cv::Point pt1, pt2;
-	double a = cos(theta), b = sin(theta);
+	double a = line->cosA, b = line->sinA;
 	double x0 = a * rho, y0 = b * rho;
 	pt1.x = cvRound(x0 + 1000 * (-b));
 	pt1.y = cvRound(y0 + 1000 * (a));
 	pt2.x = cvRound(x0 - 1000 * (-b));
 	pt2.y = cvRound(y0 - 1000 * (a));
-	finalines[index][0] = pt1.x;
-	finalines[index][1] = pt1.y;
-	finalines[index][2] = pt2.x;
-	finalines[index][3] = pt2.y;
+	ctx.finalines[index][0] = pt1.x;
+	ctx.finalines[index][1] = pt1.y;
+	ctx.finalines[index][2] = pt2.x;
+	ctx.finalines[index][3] = pt2.y;
 
 	lineAngles.push_back(line->angle);
 }
 
-void makeFinalLines(vector<quadrNode>& top10, int i0,
+void makeFinalLines(BorderContext& ctx, vector<quadrNode>& top10, int i0,
 		vector<OppositeLines>& horiPairs, vector<OppositeLines>& vertPairs, vector<double>& lineAngles){
 
 	int finalK = top10[i0].k;
@@ -27,23 +27,23 @@ void makeFinalLines(vector<quadrNode>& top10, int i0,
 
 //  Mat dist = src.clone();
 
-	makeFinalLine(0,(CvLinePolar2*) cvGetSeqElem(lines, horiPairs[finalK].one), lineAngles);
+	makeFinalLine(ctx, 0,&ctx.lines[horiPairs[finalK].one], lineAngles);
 	//cv::line( dist, pt1, pt2, CV_RGB(0,255,0),4);double areaScore[3][30];
 	//std::cout<<"line "<<line->angle<<" "<<line->rho<<std::endl;
 
-	makeFinalLine(1,(CvLinePolar2*) cvGetSeqElem(lines, horiPairs[finalK].two), lineAngles);
+	makeFinalLine(ctx, 1,&ctx.lines[horiPairs[finalK].two], lineAngles);
 	//cv::line( dist, pt1, pt2, CV_RGB(0,255,0),4);
 	//std::cout<<"line "<<line->angle<<" "<<line->rho<<std::endl;
 
-	makeFinalLine(2,(CvLinePolar2*) cvGetSeqElem(lines, vertPairs[finalL].one), lineAngles);
+	makeFinalLine(ctx, 2,&ctx.lines[vertPairs[finalL].one], lineAngles);
 	//cv::line( dist, pt1, pt2, CV_RGB(0,255,0),4);
 	//std::cout<<"line "<<line->angle<<" "<<line->rho<<std::endl;
 
-	makeFinalLine(3,(CvLinePolar2*) cvGetSeqElem(lines, vertPairs[finalL].two), lineAngles);
+	makeFinalLine(ctx, 3,&ctx.lines[vertPairs[finalL].two], lineAngles);
 	//cv::line( dist, pt1, pt2, CV_RGB(0,255,0),4);
 }
 
-void makeCorners(vector<cv::Point2f>& corners, Mat& src){
+void makeCorners(const vector<Vec4i>& finalines, vector<cv::Point2f>& corners, Mat& src){
 	corners.clear();
 	for (int i = 0; i < finalines.size(); i++) {
 		for (int j = i + 1; j < finalines.size(); j++) {
@@ -67,7 +67,7 @@ void makeCorners(vector<cv::Point2f>& corners, Mat& src){
 	}
 }
 
-bool validateCorners(vector<cv::Point2f>& corners, Mat& slt, bool binary, vector<double> lineAngles){
+bool validateCorners(BorderContext& ctx, vector<cv::Point2f>& corners, Mat& slt, bool binary, vector<double> lineAngles){
 	std::vector<cv::Point2f> approx;
 	cv::approxPolyDP(cv::Mat(corners), approx,
 			cv::arcLength(cv::Mat(corners), true) * 0.02, true);
@@ -77,8 +77,7 @@ bool validateCorners(vector<cv::Point2f>& corners, Mat& slt, bool binary, vector
 		return false;	//return;
 	}
 
-	center.x = 0.0;
-	center.y = 0.0;
+	cv::Point2f center(0, 0);
 	// Get mass center
 	for (int i = 0; i < corners.size(); i++)
 		center += corners[i];
@@ -94,16 +93,16 @@ bool validateCorners(vector<cv::Point2f>& corners, Mat& slt, bool binary, vector
 		return false;	//return;
 	}
 
-	bool doubtThis = doubtShape(lineAngles,corners, slt, binary);//binary ? false : doubtShape(corners, slt);
+	bool doubtThis = doubtShape(ctx, lineAngles,corners, slt, binary);//binary ? false : doubtShape(corners, slt);
 	//		if (doubtThis)
 	//		{	doubtCount++;//doubts.push_back(corners);//(dist);
 	//          reason.push_back(myreason);}
 	return !doubtThis;
 }
 
-//from the queue, to get candidates to result crosses
-void collectCrossCands(Mat& src, Mat& slt, vector<vector<cv::Point2f> >& crosses,
-		priority_queue<quadrNode>& qn, vector<OppositeLines> horiPairs, vector<OppositeLines> vertPairs,
+//from the best quadrangles by decreasing score, to get candidates to result crosses
+void collectCrossCands(BorderContext& ctx, Mat& src, Mat& slt, vector<vector<cv::Point2f> >& crosses,
+		const vector<quadrNode>& qn, vector<OppositeLines>& horiPairs, vector<OppositeLines>& vertPairs,
 		bool binary) {
 
 	std::vector<cv::Point2f> corners;
@@ -111,32 +110,28 @@ void collectCrossCands(Mat& src, Mat& slt, vector<vector<cv::Point2f> >& crosses
 //	cout<<"size "<<src.cols<<" "<<src.rows<<endl;
 //	cout<<"qn size "<<qn.size()<<endl;
 
-	int mscore = qn.top().score;
+	int mscore = qn[0].score;
 
 	vector<quadrNode> top10;
 
-	for (int i = 0; qn.size() > 0 && (binary? i<3:(i < 20 || qn.top().score > mscore / 3));
+	for (int i = 0; i < qn.size() && (binary? i<3:(i < 20 || qn[i].score > mscore / 3));
 			i++) {
-		top10.push_back(qn.top());
-		qn.pop();
+		top10.push_back(qn[i]);
 	}
 
-	while (!qn.empty())
-		qn.pop();
-
 //	int doubtCount = 0;
 	int i0 = 0;
 	for (; i0 < top10.size() && i0 < 30; i0++) {
 		lineAngles.clear();
-		makeFinalLines(top10, i0,horiPairs,vertPairs, lineAngles);
-		makeCorners(corners, src);
-		bool valid = validateCorners(corners, slt, binary, lineAngles);
+		makeFinalLines(ctx, top10, i0,horiPairs,vertPairs, lineAngles);
+		makeCorners(ctx.finalines, corners, src);
+		bool valid = validateCorners(ctx, corners, slt, binary, lineAngles);
 
 		//cout<<"score "<<top10[i0].score<<endl;
 		if (valid){
 			crosses.push_back(corners);		//(dist);
 			//spaceScore[curphase][scoreCur[curphase]]=((int)top10[i0].score);
-			lineScore[curphase][scoreCur[curphase]++] = ((int) top10[i0].score);
+			ctx.lineScore[ctx.curphase][ctx.scoreCur[ctx.curphase]++] = ((int) top10[i0].score);
 			//cout<<"phase-cur: "<<scoreCur[curphase]<<endl;
 			if (binary)
 				return;
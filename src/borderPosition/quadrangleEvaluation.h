@@ -12,8 +12,7 @@ struct quadrNode {
 
 //TODO detect the qudrangle a real one or fake one, with the continuing points
 bool isRealQuadr(cv::Mat pic, cv::Vec4i xylines[], Vec4i lineSeg[], int thresh,
-		int size, double& score, bool debug, int k, int l,
-		priority_queue<quadrNode>& qn) {
+		int size, double& score, bool debug) {
 
 	cv::Point2f pt[4];
 	thresh = 7;
@@ -55,11 +54,6 @@ bool isRealQuadr(cv::Mat pic, cv::Vec4i xylines[], Vec4i lineSeg[], int thresh,
 				<< endl;
 
 	//std::cout<<"true quadr"<<std::endl;
-	quadrNode n;
-	n.k = k;
-	n.l = l;
-	n.score = score;
-	qn.push(n);
 	return true;
 }
 
@@ -290,10 +284,8 @@ bool isLikeRect(CvLinePolar2 ** clines, bool debug) {
 	return true;
 }
 
-bool doubt = true;
-
 //though it is a quadrangle, the shape should be good
-bool doubtShape(vector<double> lineAngles, vector<cv::Point2f> corners, Mat slt, bool binary) {
+bool doubtShape(BorderContext& ctx, vector<double> lineAngles, vector<cv::Point2f> corners, Mat slt, bool binary) {
 
 	double d01;
 	distance(corners[0], corners[1], d01);
@@ -368,7 +360,7 @@ bool doubtShape(vector<double> lineAngles, vector<cv::Point2f> corners, Mat slt,
 //	if(fabs(angleToHori(lineAngles[0])-angleToHori(lineAngles[1]))<HORITHRESH&&(ang0<ACUTETHRESH&&ang2<ACUTETHRESH||ang1<ACUTETHRESH&&ang3<ACUTETHRESH))
 //		return true;
 
-	pair<float, float> pr = binary?coverage(corners, slt):pair<float,float>(1,1);
+	pair<float, float> pr = binary?ctx.coverage.of(corners):pair<float,float>(1,1);
 //	cout<<"PR "<<pr.first<<" "<<pr.second<<endl;
 	//
 	//	if(pr.first>0&&pr.first<0.9) return true;
@@ -381,13 +373,14 @@ bool doubtShape(vector<double> lineAngles, vector<cv::Point2f> corners, Mat slt,
 		return true;
 	}
 	if (pr.first > 0.85 && pr.second > 0.85)
-		doubt = true;//TODO it is nonsense to force to run different light modes! it should be false logically
+		ctx.doubt = true;//TODO it is nonsense to force to run different light modes! it should be false logically
 	//reason = "";
-	anglScore[curphase][scoreCur[curphase]] = myAngleScore(lineAngles, ang0, ang1, ang2,
+	int cur = ctx.scoreCur[ctx.curphase];
+	ctx.anglScore[ctx.curphase][cur] = myAngleScore(lineAngles, ang0, ang1, ang2,
 			ang3);
 
-	areaScore[curphase][scoreCur[curphase]] = areascore;
-	spaceScore[curphase][scoreCur[curphase]] = (d01 + d12 + d23 + d30);
+	ctx.areaScore[ctx.curphase][cur] = areascore;
+	ctx.spaceScore[ctx.curphase][cur] = (d01 + d12 + d23 + d30);
 	return false;
 }
 
@@ -1,60 +1,33 @@
 #ifndef BORDER_QUADRA_SCORE_H
 #define BORDER_QUADRA_SCORE_H
 
-int lineScore[3][30];
-int anglScore[3][30];
-int spaceScore[3][30];
-int areaScore[3][30];
-int scoreCur[3] = { 0, 0, 0 };
-vector<int> tLineScore;
-vector<double> tAnglScore;
-vector<int> tAreaScore;
-vector<double> tSpaceScore;
-int curphase = 0;
-int topRank[90];
-int finalRank[30];
-int spaceRank[30];
-int angleRank[30];
-int spaceRankDic[30];
-int angleRankDic[30];
-
-int compareAngleScore(const void * a, const void * b) {
-	int ai = *(int*) a;
-	int bi = *(int*) b;
-
-	int scorea = tAnglScore[topRank[ai]];
-	int scoreb = tAnglScore[topRank[bi]];
+//comparisons of the candidates ai and bi of ctx, for BorderIndexLess
+int compareAngleScore(const BorderContext& ctx, int ai, int bi) {
+	int scorea = ctx.tAnglScore[ctx.topRank[ai]];
+	int scoreb = ctx.tAnglScore[ctx.topRank[bi]];
 
 	return scorea - scoreb;
 }
 
-int compareSpaceScore(const void * a, const void * b) {
-	int ai = *(int*) a;
-	int bi = *(int*) b;
-
-	int scorea = tSpaceScore[topRank[ai]];
-	int scoreb = tSpaceScore[topRank[bi]];
+int compareSpaceScore(const BorderContext& ctx, int ai, int bi) {
+	int scorea = ctx.tSpaceScore[ctx.topRank[ai]];
+	int scoreb = ctx.tSpaceScore[ctx.topRank[bi]];
 
 	return scoreb - scorea;
 }
 
-int compareFinalScore(const void * a, const void * b) {
+int compareFinalScore(const BorderContext& ctx, int ai, int bi) {
 	double weight = 3;
 	//return 0;
-	int ai = *(int*) a;
-	int bi = *(int*) b;
-
-	double scorea = spaceRankDic[ai] * (1.0+tAnglScore[topRank[ai]]);
-	double scoreb = spaceRankDic[bi] * (1.0+tAnglScore[topRank[bi]]);
+	double scorea = ctx.spaceRankDic[ai] * (1.0+ctx.tAnglScore[ctx.topRank[ai]]);
+	double scoreb = ctx.spaceRankDic[bi] * (1.0+ctx.tAnglScore[ctx.topRank[bi]]);
 
 	if(scorea<scoreb) return -1;
 	if(scorea>scoreb) return 1;
 	return 0;
 }
 
-int compareTopScore(const void * a, const void * b) {
-	int ai = *(int*) a;
-	int bi = *(int*) b;
+int compareTopScore(const BorderContext& ctx, int ai, int bi) {
 	//Currently nonsense
 //	if (tAreaScore[ai] < tAreaScore[bi])
 //		return 1;
@@ -62,9 +35,9 @@ int compareTopScore(const void * a, const void * b) {
 //		return -1;
 
 	//only compare line scores
-	if (tLineScore[ai] < tLineScore[bi])
+	if (ctx.tLineScore[ai] < ctx.tLineScore[bi])
 		return 1;
-	if (tLineScore[ai] > tLineScore[bi])
+	if (ctx.tLineScore[ai] > ctx.tLineScore[bi])
 		return -1;
 
 	return 0;
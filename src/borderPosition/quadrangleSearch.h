@@ -0,0 +1,299 @@
+/*
+ * quadrangleSearch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_BORDERPOSITION_QUADRANGLESEARCH_H_
+#define IMAGE_PROCESS_SRC_BORDERPOSITION_QUADRANGLESEARCH_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+//by decreasing score, then by k and l
+bool quadrNodeBefore(const quadrNode& a, const quadrNode& b) {
+	if (a.score != b.score)
+		return a.score > b.score;
+	if (a.k != b.k)
+		return a.k < b.k;
+	return a.l < b.l;
+}
+
+/*
+ * The TOP_K best real quadrangles of a part of the candidates, and the best
+ * one with right angles: the last of the highest score in (k, l) order, as
+ * the sequential search picked it.
+ */
+struct QuadrTop {
+	enum {
+		TOP_K = 30
+	};
+
+	QuadrTop() :
+			bestK(-1), bestL(-1), bestScore(-1) {
+	}
+
+	void add(const quadrNode& node) {
+		if (nodes.size() == TOP_K && !quadrNodeBefore(node, nodes.back()))
+			return;
+		nodes.insert(upper_bound(nodes.begin(), nodes.end(), node,
+				quadrNodeBefore), node);
+		if (nodes.size() > TOP_K)
+			nodes.pop_back();
+	}
+
+	void addBest(int k, int l, double score) {
+		if (bestScore <= score) {
+			bestK = k;
+			bestL = l;
+			bestScore = score;
+		}
+	}
+
+	//other covers candidates after the ones of this
+	void merge(const QuadrTop& other) {
+		for (unsigned int i = 0; i < other.nodes.size(); i++)
+			add(other.nodes[i]);
+		if (other.bestK >= 0)
+			addBest(other.bestK, other.bestL, other.bestScore);
+	}
+
+	vector<quadrNode> nodes; //by quadrNodeBefore
+	int bestK, bestL;
+	double bestScore;
+};
+
+/*
+ * Composes quadrangles from the first MAX_PAIRS horizontal and vertical
+ * line pairs of process(). The Cartesian form and the normalized angle of
+ * each line, and the crossing of each horizontal line with each vertical
+ * one, are computed once. A combination is dropped as soon as a crossing is
+ * out of the padded image or not near a right angle, or the perimeter is
+ * too small. Only the survivors are checked on the edges, in parallel.
+ */
+class QuadrangleSearch {
+public:
+	enum {
+		MAX_PAIRS = 50, EVAL_STRIPES = 16
+	};
+
+	QuadrangleSearch(vector<CvLinePolar2>& lines,
+			const vector<OppositeLines>& horiPairs,
+			const vector<OppositeLines>& vertPairs, int width, int height) :
+			lines(lines), horiPairs(horiPairs), vertPairs(vertPairs), width(
+					width), height(height) {
+		prepare();
+		for (int k = 0; k < MAX_PAIRS && k < horiPairs.size(); k++) {
+			for (int l = 0; l < MAX_PAIRS && l < vertPairs.size(); l++) {
+				Candidate cand;
+				if (compose(k, l, cand))
+					cands.push_back(cand);
+			}
+		}
+	}
+
+	int candidateNum() const {
+		return cands.size();
+	}
+
+	//checks the candidates on the edges pic
+	void search(const Mat& pic, QuadrTop& top) const;
+
+	//checks candidate i, into top
+	void evaluate(int i, const Mat& pic, QuadrTop& top) const {
+		const Candidate& cand = cands[i];
+		const OppositeLines &pair1 = horiPairs[cand.k], &pair2 = vertPairs[cand.l];
+		Vec4i xylines[4] = { xy[pair1.one], xy[pair1.two], xy[pair2.one],
+				xy[pair2.two] };
+		Vec4i segs[4] = { lines[pair1.one].seg, lines[pair1.two].seg,
+				lines[pair2.one].seg, lines[pair2.two].seg };
+		double score = 0;
+		if (!isRealQuadr(pic, xylines, segs, THRESHOLD[1], SIZE[1], score,
+				cand.debug))
+			return;
+		quadrNode n;
+		n.k = cand.k;
+		n.l = cand.l;
+		n.score = score;
+		top.add(n);
+		if (cand.rightAngles)
+			top.addBest(cand.k, cand.l, score);
+	}
+
+private:
+	struct Candidate {
+		int k, l;
+		bool rightAngles; //the angle sum of its opposite sides is near 0 or PI
+		bool debug;
+	};
+
+	struct Crossing {
+		Point2f pt;
+		bool ok; //in the padded image, at a near right angle
+	};
+
+	//lines of the pairs: Cartesian form, normalized angle and crossings
+	void prepare() {
+		xy.assign(lines.size(), Vec4i());
+		normAngle.assign(lines.size(), 0);
+		horiId.assign(lines.size(), -1);
+		vertId.assign(lines.size(), -1);
+		vector<int> hori, vert;
+		for (int k = 0; k < MAX_PAIRS && k < horiPairs.size(); k++) {
+			addLine(horiPairs[k].one, horiId, hori);
+			addLine(horiPairs[k].two, horiId, hori);
+		}
+		for (int l = 0; l < MAX_PAIRS && l < vertPairs.size(); l++) {
+			addLine(vertPairs[l].one, vertId, vert);
+			addLine(vertPairs[l].two, vertId, vert);
+		}
+
+		int padding = 10.0;
+		crossings.resize(hori.size() * vert.size());
+		for (unsigned int h = 0; h < hori.size(); h++) {
+			for (unsigned int v = 0; v < vert.size(); v++) {
+				Crossing& c = crossings[h * vert.size() + v];
+				c.pt = computeLineIntersect(xy[hori[h]], xy[vert[v]]);
+				double dnangle = fabs(
+						lines[hori[h]].angle - lines[vert[v]].angle);
+				//s3.3.1 if the intersect point of two lines is outside the range of picture, fail to compose
+				//s3.3.2 if the angle between the two lines is too far from Right Angle, fail to compose
+				c.ok = !(c.pt.x < -padding || c.pt.y < -padding
+						|| c.pt.x > width + padding
+						|| c.pt.y > height + padding)
+						&& ((dnangle >= CV_PI / 3.0
+								&& dnangle <= CV_PI * 2.0 / 3.0)
+								|| (dnangle >= CV_PI * 4.0 / 3.0 - 0.04
+										&& dnangle <= CV_PI * 5.0 / 3.0));
+			}
+		}
+		vertNum = vert.size();
+	}
+
+	void addLine(int line, vector<int>& id, vector<int>& ids) {
+		if (id[line] >= 0)
+			return;
+		if (horiId[line] < 0 && vertId[line] < 0) {
+			xy[line] = polarToPoints(&lines[line]);
+			normAngle[line] = normalizeAngle(&lines[line], width, height);
+		}
+		id[line] = ids.size();
+		ids.push_back(line);
+	}
+
+	const Crossing& crossing(int hori, int vert) const {
+		return crossings[horiId[hori] * vertNum + vertId[vert]];
+	}
+
+	//the checks of a candidate that do not need the edges
+	bool compose(int k, int l, Candidate& cand) const {
+		const OppositeLines &pair1 = horiPairs[k], &pair2 = vertPairs[l];
+		if (pair1.one == pair2.one || pair1.one == pair2.two
+				|| pair1.two == pair2.one || pair1.two == pair2.two)
+			return false;
+		int idx[4] = { pair1.one, pair1.two, pair2.one, pair2.two };
+
+		cv::Point2f pt[4];
+		for (int n = 0; n < 4; n++) {
+			const Crossing& c = crossing(idx[n / 2], idx[2 + n % 2]);
+			if (!c.ok)
+				return false;
+			pt[n] = c.pt;
+		}
+
+		//s3.3.3 the found quadrangle must be large enough
+		double circ = dist(pt[0], pt[1]) + dist(pt[1], pt[3])
+				+ dist(pt[2], pt[3]) + dist(pt[0], pt[2]);
+		if (circ <= (width + height) * 0.5)
+			return false;
+
+		//s3.3.4 there must not be too strange positions of different angles
+		int sort_arr[4] = { 0, 1, 2, 3 };
+		for (int sort_cur1 = 0; sort_cur1 < 4; sort_cur1++) {
+			for (int sort_cur2 = sort_cur1 + 1; sort_cur2 < 4; sort_cur2++) {
+				int ix1 = sort_arr[sort_cur1];
+				int ix2 = sort_arr[sort_cur2];
+				if (normAngle[idx[ix1]] > normAngle[idx[ix2]]) {
+					sort_arr[sort_cur1] = ix2;
+					sort_arr[sort_cur2] = ix1;
+				}
+			}
+		}
+		if (!(sort_arr[0] / 2 != sort_arr[1] / 2
+				&& sort_arr[1] / 2 != sort_arr[2] / 2))
+			return false;
+
+		CvLinePolar2* clines[4];
+		double theta[4];
+		for (int m = 0; m < 4; m++) {
+			clines[m] = &lines[idx[m]];
+			theta[m] = clines[m]->rho >= 0 ?
+					clines[m]->angle : -CV_PI + clines[m]->angle;
+		}
+		double angleSum = fabs(theta[0] - theta[1]) + fabs(theta[2] - theta[3]);//TODO this is a problem!That when angleSum is nearly PI...like the cat book!
+		if (angleSum > CV_PI && !(2 * CV_PI - angleSum < CV_PI / 6))
+			angleSum -= CV_PI;
+
+		cand.k = k;
+		cand.l = l;
+		cand.rightAngles = angleSum < CV_PI / 6 || CV_PI - angleSum < CV_PI / 6
+				|| 2 * CV_PI - angleSum < CV_PI / 6;
+		cand.debug = k == 0 && l == 2;
+		//s3.3.5 filter and order the quadrangles with their likeliness to be real rectangles
+		return isLikeRect(clines, cand.debug);
+	}
+
+	vector<CvLinePolar2>& lines;
+	const vector<OppositeLines>& horiPairs;
+	const vector<OppositeLines>& vertPairs;
+	int width, height;
+
+	vector<Vec4i> xy;
+	vector<double> normAngle;
+	vector<int> horiId, vertId; //index of a line in the rows, the columns of crossings
+	int vertNum;
+	vector<Crossing> crossings;
+	vector<Candidate> cands;
+};
+
+/*
+ * Evaluates stripe s of the candidates into tops[s].
+ */
+class QuadrEvalBody: public ParallelLoopBody {
+public:
+	QuadrEvalBody(const QuadrangleSearch& search, const Mat& pic, int stripes,
+			QuadrTop* tops) :
+			search(search), pic(pic), stripes(stripes), tops(tops) {
+	}
+
+	void operator()(const Range& range) const {
+		int n = search.candidateNum();
+		for (int s = range.start; s < range.end; s++) {
+			for (int i = n * s / stripes; i < n * (s + 1) / stripes; i++)
+				search.evaluate(i, pic, tops[s]);
+		}
+	}
+
+private:
+	const QuadrangleSearch& search;
+	const Mat& pic;
+	int stripes;
+	QuadrTop* tops;
+};
+
+void QuadrangleSearch::search(const Mat& pic, QuadrTop& top) const {
+	int stripes = min(candidateNum(), (int) EVAL_STRIPES);
+	if (stripes == 0)
+		return;
+	vector<QuadrTop> tops(stripes);
+	parallel_for_(Range(0, stripes), QuadrEvalBody(*this, pic, stripes, &tops[0]));
+	for (int s = 0; s < stripes; s++)
+		top.merge(tops[s]);
+}
+
+#endif /* IMAGE_PROCESS_SRC_BORDERPOSITION_QUADRANGLESEARCH_H_ */
@@ -58,7 +58,7 @@ public:
 
 	static Mat addRandomBackground(Mat& src, Mat& dst, RNG& rng, int count,
 			double alpha, double beta) {
-		Mat mask(src.size(), src.type());
+		Mat mask = Mat::zeros(src.size(), src.type());
 		Drawing_Random_Filled_Polygons(mask, rng, src.cols, src.rows);
 		addWeighted(src, alpha, mask, beta, 0, dst);
 		return dst;
@@ -10,6 +10,7 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include "../utils/FileUtil.h"
+#include "../../util/stageTimer.h"
 
 using namespace std;
 using namespace cv;
@@ -179,6 +180,8 @@ public:
 	 **********************************************************/
 	static void NiblackSauvolaWolfJolion(Mat& img, Mat& output,
 			NiblackVersion version, int winx, int winy, double k, double dR) {
+		static StageId stage("preprocess/binarize");
+		ScopedTimer timer(stage);
 
 //		Size sz = Size(img.cols/2, img.rows/2);
 //		Mat imgSmall(sz, img.type());
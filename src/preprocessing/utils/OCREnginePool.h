@@ -0,0 +1,195 @@
+/*
+ * OCREnginePool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_PREPROCESSING_UTILS_OCRENGINEPOOL_H_
+#define IMAGE_PROCESS_SRC_PREPROCESSING_UTILS_OCRENGINEPOOL_H_
+
+#include <tesseract/baseapi.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+using namespace tesseract;
+
+/*
+ * Keeps initialized tesseract engines alive, keyed by language string
+ * (e.g. "eng+jpn+chi_sim"), so the tessdata is loaded once per engine
+ * instead of once per text piece.
+ * At most maxSize engines are created for one language; acquire() blocks
+ * when all of them are in use.
+ */
+class OCREnginePool {
+public:
+	static OCREnginePool& instance() {
+		static OCREnginePool pool;
+		return pool;
+	}
+
+	/*
+	 * Upper bound of engines per language. Engines already created are kept.
+	 */
+	void setMaxSize(int size) {
+		lock_guard<mutex> lock(mtx);
+		maxSize = size < 1 ? 1 : size;
+		cond.notify_all();
+	}
+
+	int getMaxSize() {
+		lock_guard<mutex> lock(mtx);
+		return maxSize;
+	}
+
+	/*
+	 * Returns an idle engine for lang, creating one if the pool is not full.
+	 * Returns NULL if tesseract can't be initialized for lang. Such a
+	 * language is remembered and not initialized again.
+	 */
+	TessBaseAPI* acquire(const string& lang) {
+		unique_lock<mutex> lock(mtx);
+		if (failed.count(lang))
+			return NULL;
+		LangPool& pool = pools[lang];
+		/*failed first: the pool of a failed language is gone*/
+		while (!failed.count(lang) && pool.idle.empty()
+				&& pool.created >= maxSize) {
+			cond.wait(lock);
+		}
+		if (failed.count(lang))
+			return NULL;
+		if (!pool.idle.empty()) {
+			TessBaseAPI* tess = pool.idle.back();
+			pool.idle.pop_back();
+			return tess;
+		}
+		pool.created++;
+		lock.unlock();
+
+		/*init outside the lock, it is the expensive part*/
+		TessBaseAPI* tess = new TessBaseAPI();
+		if (tess->Init(NULL, lang.c_str(), OEM_TESSERACT_ONLY) != 0) {
+			cerr << "Could not initialize tesseract with language " << lang
+					<< endl;
+			delete tess;
+			lock.lock();
+			failed.insert(lang);
+			if (--pools[lang].created == 0)
+				pools.erase(lang);
+			cond.notify_all();
+			return NULL;
+		}
+		return tess;
+	}
+
+	/*
+	 * Whether engines can be created for lang, initializing the first one
+	 * if there is none yet.
+	 */
+	bool available(const string& lang) {
+		{
+			lock_guard<mutex> lock(mtx);
+			if (failed.count(lang))
+				return false;
+			map<string, LangPool>::iterator it = pools.find(lang);
+			if (it != pools.end() && it->second.created > 0)
+				return true;
+		}
+		TessBaseAPI* tess = acquire(lang);
+		release(lang, tess);
+		return tess != NULL;
+	}
+
+	/*
+	 * Clears the recognition results and gives the engine back to the pool.
+	 */
+	void release(const string& lang, TessBaseAPI* tess) {
+		if (tess == NULL)
+			return;
+		tess->Clear();
+		lock_guard<mutex> lock(mtx);
+		pools[lang].idle.push_back(tess);
+		cond.notify_one();
+	}
+
+	/*
+	 * Creates (up to maxSize) count engines for lang ahead of the first request.
+	 */
+	void warmUp(const string& lang, int count) {
+		vector<TessBaseAPI*> engines;
+		for (int i = 0; i < count && i < getMaxSize(); i++) {
+			TessBaseAPI* tess = acquire(lang);
+			if (tess == NULL)
+				break;
+			engines.push_back(tess);
+		}
+		for (unsigned int i = 0; i < engines.size(); i++) {
+			release(lang, engines[i]);
+		}
+	}
+
+	~OCREnginePool() {
+		for (map<string, LangPool>::iterator it = pools.begin();
+				it != pools.end(); it++) {
+			for (unsigned int i = 0; i < it->second.idle.size(); i++) {
+				it->second.idle[i]->End();
+				delete it->second.idle[i];
+			}
+		}
+	}
+
+private:
+	struct LangPool {
+		vector<TessBaseAPI*> idle;
+		int created;
+		LangPool() :
+				created(0) {
+		}
+	};
+
+	OCREnginePool() :
+			maxSize(4) {
+	}
+	OCREnginePool(const OCREnginePool&);
+	OCREnginePool& operator=(const OCREnginePool&);
+
+	map<string, LangPool> pools;
+	set<string> failed; //languages tesseract could not be initialized with
+	mutex mtx;
+	condition_variable cond;
+	int maxSize;
+};
+
+/*
+ * Holds one engine of the pool for the lifetime of the object.
+ */
+class OCREngineLease {
+public:
+	OCREngineLease(const string& lang) :
+			lang(lang), tess(OCREnginePool::instance().acquire(lang)) {
+	}
+	~OCREngineLease() {
+		OCREnginePool::instance().release(lang, tess);
+	}
+	TessBaseAPI* get() {
+		return tess;
+	}
+	TessBaseAPI* operator->() {
+		return tess;
+	}
+private:
+	OCREngineLease(const OCREngineLease&);
+	OCREngineLease& operator=(const OCREngineLease&);
+
+	string lang;
+	TessBaseAPI* tess;
+};
+
+#endif /* IMAGE_PROCESS_SRC_PREPROCESSING_UTILS_OCRENGINEPOOL_H_ */
@@ -13,6 +13,8 @@
 #include <tesseract/strngs.h>
 #include <iostream>
 #include "FileUtil.h"
+#include "OCREnginePool.h"
+#include "../../util/stageTimer.h"
 
 using namespace cv;
 using namespace std;
@@ -21,16 +23,32 @@ using namespace tesseract;
 class OCRUtil
 {
 public:
+	/*
+	 * The engine comes from OCREnginePool, so the language data is only
+	 * loaded the first time an engine for lang is created.
+	 */
 	static string ocrFile(Mat& src, const string lang = "eng+jpn+chi_sim") {
 
-		TessBaseAPI tess;
+		OCREngineLease tess(lang);
+		if (tess.get() == NULL) {
+			return "";
+		}
+		return ocrFile(src, tess.get());
+	}
+
+	/*
+	 * Recognizes src with an engine the caller holds (e.g. one lease per
+	 * thread), the engine is cleared afterwards.
+	 */
+	static string ocrFile(Mat& src, TessBaseAPI* tess) {
+		static StageId stage("ocr/piece");
+		ScopedTimer timer(stage);
 
 //		cout<<src.cols<<" "<<src.rows<<endl;
 //		imshow("xxx",src);
 //		waitKey();
 
-		/*init*/
-		tess.Init(NULL, lang.c_str(), OEM_TESSERACT_ONLY);
+		/*init is done by the pool*/
 		/*
 		 * we can also use configuration files for the tesseract, such as whether to use a dictionary
 		 */
@@ -40,8 +58,7 @@ public:
 //		tess.Init("/home/litton/tessdata", lang.c_str(), OEM_DEFAULT, configs, 2, NULL, NULL, false);
 
 		/*default page segmentation mode*/
-		tess.SetPageSegMode(PSM_AUTO_ONLY);
-		tess.SetPageSegMode(PSM_SINGLE_BLOCK);// Currently, for English name card, we use this way!
+		tess->SetPageSegMode(PSM_SINGLE_BLOCK);// Currently, for English name card, we use this way!
 		/* if we first use the binarization algorithm for ourself, we can change it as a bit-wise
 		 * graph for more fast processing
 		 */
@@ -93,10 +110,10 @@ public:
 //		}
 
 		/*for greyscale image*/
-		tess.SetImage((uchar*) src.data, src.cols, src.rows, 1, src.cols);
+		tess->SetImage((uchar*) src.data, src.cols, src.rows, 1, src.cols);
 
 		/*for color image*/
-//		tess.SetImage((uchar*) src.data, src.cols, src.rows, 3, 3*src.cols);
+//		tess->SetImage((uchar*) src.data, src.cols, src.rows, 3, 3*src.cols);
 
 		/*for leptopia pix image*/
 //		tess.SetImage(src);
@@ -108,7 +125,7 @@ public:
 //		tess.SetSourceResolution(100);
 
 		/*get result*/
-		char* out = tess.GetUTF8Text();
+		char* out = tess->GetUTF8Text();
 
 		/*get different segmentation of the photo*/
 //		ResultIterator* itor = tess.GetIterator();
@@ -117,10 +134,11 @@ public:
 //			cout<<"TYPE: "<<itor->BlockType()<<endl<<"CONTENT: "<<endl<<itor->GetUTF8Text(RIL_BLOCK)<<endl;
 //		}
 
-		/*clear up*/
-		string s = string(out);
+		/*clear up, the engine stays initialized for the next piece*/
+		string s = out == NULL ? "" : string(out);
+		delete[] out;
 //		delete itor;
-		tess.End();
+		tess->Clear();
 
 		return s;
 	}
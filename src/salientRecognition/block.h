@@ -179,6 +179,18 @@ public:
 		first_free = (block_item *) t;
 	}
 
+	/* Deletes all items, the memory is kept for the next New() calls */
+	void Reset() {
+		first_free = NULL;
+		for (block *b = first; b; b = b->next) {
+			block_item *item = &(b->data[0]);
+			for (int k = 0; k < block_size; k++, item++) {
+				item->next_free = first_free;
+				first_free = item;
+			}
+		}
+	}
+
 	/***********************************************************************/
 
 private:
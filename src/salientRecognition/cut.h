@@ -9,10 +9,11 @@
 #define CUT_H_
 
 #include <opencv2/opencv.hpp>
-#include "main.h"
+#include "rc/main.h"
 #include <queue>
 #include <list>
 #include "graph.h"
+#include "graphPool.h"
 #include "gmm.h"
 
 using namespace std;
@@ -47,6 +48,11 @@ public: // Functions for GrabCut
 	void refine() {int changed = 1; while (changed) changed = refineOnce();}
 	int refineOnce();
 
+	// Computes the last flow again without the search trees of the previous one, as graph.h
+	// suggests to check the nodes marked by updateTLinks. Returns the number of unknown pixels
+	// whose segment changes, 0 if every update was marked.
+	int checkReuse();
+
 	// Edit Trimap, mask values should be 0 or 255
 	void setTrimap(CMat &mask1u, const TrimapValue t) {_trimap1i.setTo(t, mask1u);}
 
@@ -69,6 +75,7 @@ private:
 	int updateHardSegmentation();
 
 	void initGraph();	// builds the graph for GraphCut
+	void updateTLinks(bool mark);
 
 
 
@@ -82,7 +89,8 @@ private:
 	float _lambda;		// lambda = 50. This value was suggested the GrabCut paper.
 	float _beta;		// beta = 1 / ( 2 * average of the squared color distances between all pairs of neighboring pixels (8-neighborhood) )
 	float _L;			// L = a large value to force a pixel to be foreground or background
-	GraphF *_graph;
+	GraphF *_graph; // from GraphPool, built by the first refineOnce()
+	Mat_<Vec2f> _TLinks; // (fore, back) T-link weights in _graph
 
 	// Storage for N-link weights, each pixel stores links to only four of its 8-neighborhood neighbors.
 	// This avoids duplication of links, while still allowing for relatively easy lookup.
@@ -94,6 +102,10 @@ private:
 	CmGMM _bGMM, _fGMM; // Background and foreground GMM
 	Mat _bGMMidx1i, _fGMMidx1i;	// Background and foreground GMM components, supply memory for GMM, not used for Grabcut
 	Mat _show3u; // Image for display medial results
+
+	// _graph belongs to one object
+	CmSalCut(const CmSalCut&);
+	CmSalCut& operator=(const CmSalCut&);
 };
 
 CmSalCut::CmSalCut(CMat &img3f)
@@ -149,8 +161,7 @@ CmSalCut::CmSalCut(CMat &img3f)
 
 CmSalCut::~CmSalCut(void)
 {
-//	if (_graph)
-//		delete _graph;
+	GraphPool<GraphF>::instance().release(_graph);
 }
 
 int CmSalCut::GetNZRegions(const Mat_<byte> &label1u, Mat_<int> &regIdx1i, vecI &idxSum)
@@ -346,14 +357,38 @@ int CmSalCut::refineOnce()
 	}
 	_bGMM.BuildGMMs(_imgBGR3f, _bGMMidx1i, complement);
 
-	// Step 6: Run GraphCut and update segmentation
-	initGraph();
-	if (_graph)
+	// Step 6: Run GraphCut and update segmentation. After the first iteration only the
+	// T-links change, the search trees of the previous flow are reused.
+	if (_graph == NULL) {
+		initGraph();
 		_graph->maxflow();
+	} else {
+		updateTLinks(true);
+		_graph->maxflow(true);
+	}
 
 	return updateHardSegmentation();
 }
 //
+int CmSalCut::checkReuse()
+{
+	if (_graph == NULL)
+		return 0;
+	_graph->maxflow(false);
+	int changed = 0;
+	for (int y = 0, id = 0; y < _h; ++y) {
+		const float* segVal = _segVal1f.ptr<float>(y);
+		const int* triMapD = _trimap1i.ptr<int>(y);
+		for (int x = 0; x < _w; ++x, id++) {
+			if (triMapD[x] != TrimapUnknown)
+				continue;
+			bool fore = _graph->what_segment(id) == GraphF::SOURCE;
+			changed += fore != (segVal[x] > 0.5f) ? 1 : 0;
+		}
+	}
+	return changed;
+}
+//
 int CmSalCut::updateHardSegmentation()
 {
 	int changed = 0;
@@ -374,32 +409,15 @@ int CmSalCut::updateHardSegmentation()
 	return changed;
 }
 
+// The topology and the N-links do not change between the iterations on an image, the graph
+// is built once and the later iterations only update its T-links (see updateTLinks).
 void CmSalCut::initGraph()
 {
-	// Set up the graph (it can only be used once, so we have to recreate it each time the graph is updated)
-	if (_graph == NULL)
-		_graph = new GraphF(_w * _h, 4 * _w * _h);
-	else
-		_graph->reset();
+	_graph = GraphPool<GraphF>::instance().acquire(_w * _h, 4 * _w * _h);
 	_graph->add_node(_w * _h);
 
 	for (int y = 0, id = 0; y < _h; ++y) {
-		int* triMapD = _trimap1i.ptr<int>(y);
-		const float* img = _imgBGR3f.ptr<float>(y);
-		for(int x = 0; x < _w; x++, img += 3, id++) {
-			float back, fore;
-			if (triMapD[x] == TrimapUnknown ) {
-				fore = -log(_bGMM.P(img));
-				back = -log(_fGMM.P(img));
-			}
-			else if (triMapD[x] == TrimapBackground )
-				fore = 0, back = _L;
-			else		// TrimapForeground
-				fore = _L,	back = 0;
-
-			// Set T-Link weights
-			_graph->add_tweights(id, fore, back); // _graph->set_tweights(_nodes(y, x), fore, back);
-
+		for(int x = 0; x < _w; x++, id++) {
 			// Set N-Link weights from precomputed values
 			Point pnt(x, y);
 			const Vec4f& nLink = _NLinks(pnt);
@@ -410,6 +428,44 @@ void CmSalCut::initGraph()
 			}
 		}
 	}
+	_TLinks = Mat_<Vec2f>::zeros(_h, _w);
+	updateTLinks(false);
+}
+
+// Set T-Link weights of the current GMMs and trimap. The graph keeps its residual capacities,
+// so only the change since the last call is added (a T-link difference shifts the cut cost of
+// a node by a constant, the minimal cut stays right). With mark, the changed nodes are marked
+// for maxflow(true).
+void CmSalCut::updateTLinks(bool mark)
+{
+	// GMM densities of the whole image at once, by rows
+	Mat fP1f, bP1f;
+	_fGMM.GetMixture(_imgBGR3f, fP1f);
+	_bGMM.GetMixture(_imgBGR3f, bP1f);
+
+	for (int y = 0, id = 0; y < _h; ++y) {
+		int* triMapD = _trimap1i.ptr<int>(y);
+		const float *fP = fP1f.ptr<float>(y), *bP = bP1f.ptr<float>(y);
+		Vec2f* tLink = _TLinks.ptr<Vec2f>(y);
+		for(int x = 0; x < _w; x++, id++) {
+			float back, fore;
+			if (triMapD[x] == TrimapUnknown ) { // capped, an infinite weight could not be updated
+				fore = min(-log(bP[x]), _L);
+				back = min(-log(fP[x]), _L);
+			}
+			else if (triMapD[x] == TrimapBackground )
+				fore = 0, back = _L;
+			else		// TrimapForeground
+				fore = _L,	back = 0;
+
+			if (fore == tLink[x][0] && back == tLink[x][1])
+				continue;
+			_graph->add_tweights(id, fore - tLink[x][0], back - tLink[x][1]);
+			if (mark)
+				_graph->mark_node(id);
+			tLink[x] = Vec2f(fore, back);
+		}
+	}
 }
 
 
@@ -24,6 +24,9 @@
 #include "segmentation/pnmfile.h"
 #include "segmentation/segment-image.h"
 #include "pyramid/pyramid.h"
+#include "salientContext.h"
+#include "salientMap.h"
+#include "regionSaliency.h"
 #include "../util/general.h"
 
 using namespace cv;
@@ -38,31 +41,40 @@ public:
 	 */
 	void salient(const char *inputPath, const char *segPath = NULL, const char *rcPath = NULL);
 	/**
-	 * which is not thread-safe
+	 * which is not thread-safe, it uses the context of this object.
+	 * Get one object per thread from SalientRecPool.
 	 */
 	void salient(Mat &input, Mat &output, Mat &seg);
+	void salient(Mat &input, SalientMap &output, Mat &seg);
+	/**
+	 * reentrant: all the state of the call is in ctx, so threads can share
+	 * this object as long as each one has its own ctx.
+	 * The SalientMap version keeps the result at the resolution it was
+	 * computed on, the Mat version upsamples it to the input size.
+	 * regions gets an approximation of it by segment, see RegionSaliency.
+	 */
+	void salient(Mat &input, Mat &output, Mat &seg, SalientContext &ctx) const;
+	void salient(Mat &input, SalientMap &output, Mat &seg, SalientContext &ctx) const;
+	void salient(Mat &input, SalientMap &output, RegionSaliency &regions, Mat &seg, SalientContext &ctx) const;
 	void wholeTest();
 	void emptyTest();
 	bool isResultUseful(Mat &input);
 	Mat convertToVisibleMatrix(Mat &input);
 private:
-	void debugStart();
-	/**
-	 * type: 1 means highContrast, 2 means lowContrast
-	 */
-	void debugEnd(Mat &input, Mat &output, GraphSegmentation *selection);
+	void compute(Mat &input, SalientMap &output, RegionSaliency *regions, Mat &seg, SalientContext &ctx) const;
+	void debugStart(SalientContext &ctx) const;
+	void debugEnd(Mat &input, Mat &output, SalientContext &ctx) const;
 private:
 	bool _debug;
 	GraphSegmentation *highContrastSeg;
 	GraphSegmentation *lowContrastSeg;
-	clock_t tic;
+	SalientContext context;
 	RegionContrastSalient *rcs;
 	RegionCut *rc;
 };
 
 SalientRec::SalientRec(bool debug):
 	_debug(debug){
-	tic = clock();
 	highContrastSeg = new GraphSegmentation(1.2, 200, 500, debug);
 	lowContrastSeg = new GraphSegmentation(0.95, 200, 500, debug);
 	rcs = new RegionContrastSalient(0.4, 2, 0.01, debug);
@@ -76,17 +88,16 @@ SalientRec::~SalientRec(){
 	delete rc;
 }
 
-void SalientRec::debugStart(){
-	tic = clock();
+void SalientRec::debugStart(SalientContext &ctx) const{
+	ctx.tic = clock();
 }
 
-void SalientRec::debugEnd(Mat &input, Mat &output, GraphSegmentation *selection){
-	Mat seg = selection->getRealSeg();
+void SalientRec::debugEnd(Mat &input, Mat &output, SalientContext &ctx) const{
 	namedWindow("Seg");
-	imshow("Seg", seg);
+	imshow("Seg", ctx.realSeg);
 	namedWindow("Final2");
 	imshow("Final2", output);
-	cout << "size:[" << input.rows << "*" << input.cols << "]" << input.rows * input.cols << "/" << float(clock() - tic) / 1000 << "ms" << endl;
+	cout << "size:[" << input.rows << "*" << input.cols << "]" << input.rows * input.cols << "/" << float(clock() - ctx.tic) / 1000 << "ms" << endl;
 }
 
 bool SalientRec::isResultUseful(Mat &input){
@@ -102,9 +113,31 @@ bool SalientRec::isResultUseful(Mat &input){
 }
 
 void SalientRec::salient(Mat &input, Mat &output, Mat &seg){
+	salient(input, output, seg, context);
+}
+
+void SalientRec::salient(Mat &input, SalientMap &output, Mat &seg){
+	salient(input, output, seg, context);
+}
+
+void SalientRec::salient(Mat &input, Mat &output, Mat &seg, SalientContext &ctx) const{
+	SalientMap map;
+	salient(input, map, seg, ctx);
+	output = map.full();
+}
+
+void SalientRec::salient(Mat &input, SalientMap &output, Mat &seg, SalientContext &ctx) const{
+	compute(input, output, NULL, seg, ctx);
+}
+
+void SalientRec::salient(Mat &input, SalientMap &output, RegionSaliency &regions, Mat &seg, SalientContext &ctx) const{
+	compute(input, output, &regions, seg, ctx);
+}
+
+void SalientRec::compute(Mat &input, SalientMap &output, RegionSaliency *regions, Mat &seg, SalientContext &ctx) const{
 	Mat regionIdxImage1i;
 	if(_debug){
-		debugStart();
+		debugStart(ctx);
 	}
 	Pyramid pyramid(input);
 	Mat scaledInput = pyramid.scale();
@@ -116,15 +149,19 @@ void SalientRec::salient(Mat &input, Mat &output, Mat &seg){
 	int regNum;
 	GraphSegmentation *selection;
 	selection = p.second > 100 ? highContrastSeg : lowContrastSeg;
-	regNum = selection->segment_image(scaledInput, regionIdxImage1i);
-	seg = selection->getRealSeg();
+	regNum = selection->segment_image(scaledInput, regionIdxImage1i, ctx);
+	seg = ctx.realSeg;
 	Mat mat1 = rcs->getRC(scaledInput, regionIdxImage1i, regNum, 0.4, false);
-	mat1 = rc->cut(mat1, regionIdxImage1i);
+	mat1 = rc->cut(mat1, regionIdxImage1i, ctx.rng);
 	// if still not found, we can choose the largest one as salient.
 //	output = convertToVisibleMat<float>(mat1);
-	output = pyramid.reScale(mat1);
+	output = SalientMap(mat1, pyramid.getScale());
+	if(regions != NULL){
+		*regions = RegionSaliency(regionIdxImage1i, regNum, mat1, pyramid.getScale());
+	}
 	if(_debug){
-		debugEnd(input, output, selection);
+		Mat full = output.full();
+		debugEnd(input, full, ctx);
 	}
 }
 
@@ -8,8 +8,9 @@
 #ifndef GMM_H_
 #define GMM_H_
 
-#include "main.h"
+#include "rc/main.h"
 #include <stdio.h>
+#include <vector>
 
 using namespace std;
 
@@ -19,6 +20,7 @@ template <int D> struct CmGaussian
 	double covar[D][D];		// covariance matrix of the Gaussian
 	double det;				// determinant of the covariance matrix
 	double inv[D][D];			// inverse of the covariance matrix
+	double logNorm;			// log((2*pi)^(-D/2) * det^(-1/2)), the log of the normalizer
 	double w;					// weighting of this Gaussian in the GMM.
 
 	// These are only needed during Orchard and Bouman clustering.
@@ -26,6 +28,8 @@ template <int D> struct CmGaussian
 	double eVectors[D][D];	// eigenvectors
 };
 
+template <int D> class CmGaussianFitter;
+
 // Gaussian mixture models
 template <int D> class CmGMM_
 {
@@ -64,6 +68,13 @@ public:
 
 	void GetProbs(CMat sampleDf, vector<Mat> &pci1f) const; // Get Probabilities of each Channel i
 
+	void GetMixture(CMat sampleDf, Mat &p1f) const; // P() of every sample, CV_32F
+
+	// Densities of every Gaussian on the n samples of row, one row of dens1f per Gaussian.
+	// soa1f receives the row split by channel (D x n) so that the per-sample loops run on
+	// contiguous floats and vectorize.
+	void RowDensities(const float *row, int n, Mat &soa1f, Mat &dens1f) const;
+
 	void iluProbs(CMat sampleDf, CStr &nameNE) const; // Get Probabilities of each Channel i, and illustrate it
 
 protected:
@@ -72,7 +83,19 @@ protected:
 	double _ThrV; // The lowest variations of Gaussian
 	CmGaussian<D>* _Guassians; // An array of K Gaussian
 
+	// Float copies of the Gaussians for RowDensities, refreshed by Prepare() whenever they change
+	vector<float> _meanF, _invF, _logNormF; // K*D, K*D*D, K
+	vector<uchar> _usable; // w > 0 and det > 0
+
+	// Stripes of rows that BuildGMMs and RefineGMMs accumulate in parallel. It does not depend on
+	// the number of threads, and the stripes are summed in order, so neither does the result.
+	enum {FIT_STRIPES = 32};
+
+	void Prepare();
 	void AssignEachPixel(CMat& sampleDf, Mat &component1i);
+	// Add the samples to fitters[component]. With nSplit >= 0, only the samples of nSplit, and those
+	// on the far side of its main eigenvector move to newIdx first.
+	void Fit(CMat& sampleDf, Mat& component1i, CMat& w1f, CmGaussianFitter<D>* fitters, int nSplit, int newIdx);
 };
 
 class CmGMM : public CmGMM_<3>{
@@ -106,6 +129,9 @@ public:
 
 	template<typename T> inline void Add(const T* _c, T _weight);
 
+	// Add the samples of another fitter
+	void Add(const CmGaussianFitter& other);
+
 	void Reset() {memset(this, 0, sizeof(CmGaussianFitter));}
 
 	// Build the Gaussian out of all the added color samples
@@ -154,6 +180,16 @@ template <int D> template<typename T> void CmGaussianFitter<D>::Add(const T* _c,
 	count += weight;
 }
 
+template <int D> void CmGaussianFitter<D>::Add(const CmGaussianFitter& other)
+{
+	for (int i = 0; i < D; i++)	{
+		s[i] += other.s[i];
+		for (int j = 0; j < D; j++)
+			p[i][j] += other.p[i][j];
+	}
+	count += other.count;
+}
+
 // Build the Gaussian out of all the added color samples
 template <int D> void CmGaussianFitter<D>::BuildGuassian(
 		CmGaussian<D>& g, double totalCount, bool computeEigens) const
@@ -180,6 +216,7 @@ template <int D> void CmGaussianFitter<D>::BuildGuassian(
 		Mat inv(D, D, CV_64FC1, g.inv);
 		invert(covar, inv, CV_LU); // Compute determinant and inverse of covariance matrix
 		g.det = determinant(covar);
+		g.logNorm = g.det > 0 ? -0.5 * (D * log(2 * CV_PI) + log(g.det)) : 0;
 		g.w = count/totalCount; // Weight is percentage of this Gaussian
 
 		if (computeEigens) 	{
@@ -191,6 +228,123 @@ template <int D> void CmGaussianFitter<D>::BuildGuassian(
 	}
 }
 
+/************************************************************************/
+/*  Row-parallel passes of CmGMM_                                       */
+/************************************************************************/
+
+// Adds the samples of stripes of rows to the fitters of their components, a set of K fitters per
+// stripe (fitters + stripe * K). See CmGMM_::Fit for the split.
+template <int D> class CmGMMFitBody : public ParallelLoopBody
+{
+public:
+	CmGMMFitBody(CMat& sampleDf, Mat& component1i, CMat& w1f, int K, int stripes, CmGaussianFitter<D>* fitters)
+		: sampleDf(sampleDf), component1i(component1i), w1f(w1f), K(K), stripes(stripes), fitters(fitters),
+		  nSplit(-1), newIdx(-1), split(0) {}
+
+	void setSplit(int nSplit, int newIdx, const double eVec[D], double split) {
+		this->nSplit = nSplit, this->newIdx = newIdx, this->split = split;
+		for (int t = 0; t < D; t++)
+			this->eVec[t] = eVec[t];
+	}
+
+	void operator()(const Range &range) const {
+		bool weighted = w1f.data != NULL;
+		int rows = sampleDf.rows, cols = sampleDf.cols;
+		for (int s = range.start; s < range.end; s++) {
+			CmGaussianFitter<D>* fit = fitters + s * K;
+			for (int y = rows * s / stripes; y < rows * (s + 1) / stripes; y++) {
+				int* components = component1i.ptr<int>(y);
+				const float* img = sampleDf.ptr<float>(y);
+				const float* w = weighted ? w1f.ptr<float>(y) : NULL;
+				for (int x = 0; x < cols; x++, img += D) {
+					int c = components[x];
+					if (nSplit >= 0) {
+						if (c != nSplit)
+							continue;
+						double tmp = 0;
+						for (int t = 0; t < D; t++)
+							tmp += eVec[t] * img[t];
+						if (tmp > split)
+							c = components[x] = newIdx;
+					}
+					if (weighted)
+						fit[c].Add(img, w[x]);
+					else
+						fit[c].Add(img);
+				}
+			}
+		}
+	}
+
+private:
+	CMat &sampleDf;
+	Mat &component1i;
+	CMat &w1f;
+	int K, stripes;
+	CmGaussianFitter<D>* fitters;
+	int nSplit, newIdx;
+	double eVec[D], split;
+};
+
+// Evaluates a CmGMM_ on rows of samples. The outputs that are not NULL get: the Gaussian of
+// highest density (component1i), the densities normalized over the Gaussians (probs) and the
+// mixture density (mixture1f).
+template <int D> class CmGMMEvalBody : public ParallelLoopBody
+{
+public:
+	CmGMMEvalBody(const CmGMM_<D> &gmm, CMat &sampleDf, Mat *component1i, vector<Mat> *probs, Mat *mixture1f)
+		: gmm(gmm), sampleDf(sampleDf), component1i(component1i), probs(probs), mixture1f(mixture1f) {}
+
+	void operator()(const Range &range) const {
+		int K = gmm.K(), cols = sampleDf.cols;
+		Mat soa1f, dens1f, acc1f(1, cols, CV_32F);
+		float* acc = acc1f.ptr<float>(0);
+		for (int y = range.start; y < range.end; y++) {
+			gmm.RowDensities(sampleDf.ptr<float>(y), cols, soa1f, dens1f);
+			if (component1i != NULL) {
+				int* component = component1i->ptr<int>(y);
+				for (int x = 0; x < cols; x++)
+					component[x] = 0, acc[x] = 0;
+				for (int i = 0; i < K; i++) {
+					const float* dens = dens1f.ptr<float>(i);
+					for (int x = 0; x < cols; x++)
+						if (dens[x] > acc[x])
+							component[x] = i, acc[x] = dens[x];
+				}
+			}
+			if (probs != NULL) {
+				acc1f = Scalar(0);
+				for (int i = 0; i < K; i++)
+					acc1f += dens1f.row(i);
+				for (int i = 0; i < K; i++) {
+					const float* dens = dens1f.ptr<float>(i);
+					float* prob = (*probs)[i].ptr<float>(y);
+					for (int x = 0; x < cols; x++)
+						prob[x] = acc[x] > 0 ? dens[x] / acc[x] : 0;
+				}
+			}
+			if (mixture1f != NULL) {
+				float* mixture = mixture1f->ptr<float>(y);
+				for (int x = 0; x < cols; x++)
+					mixture[x] = 0;
+				for (int i = 0; i < K; i++) {
+					const float* dens = dens1f.ptr<float>(i);
+					float w = (float)gmm.getWeight(i);
+					for (int x = 0; x < cols; x++)
+						mixture[x] += w * dens[x];
+				}
+			}
+		}
+	}
+
+private:
+	const CmGMM_<D> &gmm;
+	CMat &sampleDf;
+	Mat *component1i;
+	vector<Mat> *probs;
+	Mat *mixture1f;
+};
+
 /************************************************************************/
 /* Gaussian mixture models                                              */
 /************************************************************************/
@@ -230,8 +384,8 @@ template <int D> double CmGMM_<D>::P(int i, const float c[D]) const
 			for(int i = 0; i < D; i++)
 				for (int j = 0; j < D; j++)
 					d += v[i] * inv[i][j] * v[j];
-			//p = (2*pi)^(k/2) * |det|^(1/2)* exp(-0.5 * (x - mu) * sigma^-1 * (x - mu))
-			result = (double)(0.0635 / sqrt(guassian.det) * exp(-0.5f * d));   // 1/(2*pi)^(3/2) = 0.0635
+			//p = (2*pi)^(-k/2) * |det|^(-1/2)* exp(-0.5 * (x - mu) * sigma^-1 * (x - mu))
+			result = exp(guassian.logNorm - 0.5 * d);
 		}
 		else {
 			if (guassian.w < 1e-3)
@@ -246,30 +400,16 @@ template <int D> double CmGMM_<D>::P(int i, const float c[D]) const
 template <int D> void CmGMM_<D>::BuildGMMs(CMat& sampleDf, Mat& component1i, CMat& w1f)
 {
 	bool weighted = w1f.data != NULL;
-	int rows = sampleDf.rows, cols = sampleDf.cols;
 	component1i = Mat::zeros(sampleDf.size(), CV_32S);
 	{
 		CV_Assert(sampleDf.data != NULL && sampleDf.type() == CV_MAKETYPE(CV_32F,D));
 		CV_Assert(!weighted || w1f.type() == CV_32FC1 && w1f.size == sampleDf.size);
-		if (sampleDf.isContinuous() && component1i.isContinuous() && (!weighted || w1f.isContinuous()))
-			cols *= sampleDf.rows, rows = 1;
-		_sumW = weighted ? sum(w1f).val[0] : rows * cols; // Finding sum weight
+		_sumW = weighted ? sum(w1f).val[0] : sampleDf.rows * sampleDf.cols; // Finding sum weight
 	}
 
 	// Initial first clusters
 	CmGaussianFitter<D>* fitters = new CmGaussianFitter<D>[_K];
-	for (int y = 0; y < rows; y++)	{
-		int* components = component1i.ptr<int>(y);
-		const float* img = sampleDf.ptr<float>(y);
-		const float* w = weighted ? w1f.ptr<float>(y) : NULL;
-		if (weighted){
-			for (int x = 0; x < cols; x++, img += D)
-				fitters[0].Add(img, w[x]);
-		}else{
-			for (int x = 0; x < cols; x++, img += D)
-				fitters[0].Add(img);
-		}
-	}
+	Fit(sampleDf, component1i, w1f, fitters, -1, -1);
 	fitters[0].BuildGuassian(_Guassians[0], _sumW, true);
 
 	// Compute clusters
@@ -278,53 +418,14 @@ template <int D> void CmGMM_<D>::BuildGMMs(CMat& sampleDf, Mat& component1i, CMa
 		// Stop splitting for small eigenvalue
 		if (_Guassians[nSplit].eValues[0] < _ThrV){
 			_K = i;
-			delete []fitters;
-			return;
+			break;
 		}
 
 		// Reset the filters for the splitting clusters
 		fitters[nSplit] = CmGaussianFitter<D>();
 
-		// For brevity, get reference to splitting Gaussian
-		CmGaussian<D>& sG = _Guassians[nSplit];
-
-		// Compute splitting point
-		double split = 0;
-		// sG.eVectors[0][0] * sG.mean[0] + sG.eVectors[1][0] * sG.mean[1] + sG.eVectors[2][0] * sG.mean[2];
-		for (int t = 0; t < D; t++)
-			split += sG.eVectors[t][0] * sG.mean[t];
-
 		// Split clusters nSplit, place split portion into cluster i
-		for (int y = 0; y < rows; y++)	{
-			int* components = component1i.ptr<int>(y);
-			const float* img = sampleDf.ptr<float>(y);
-			if (weighted){
-				const float* w = w1f.ptr<float>(y);
-				for (int x = 0; x < cols; x++, img += D) {// for each pixel
-					if (components[x] != nSplit)
-						continue;
-					double tmp = 0;
-					for (int t = 0; t < D; t++)
-						tmp += sG.eVectors[t][0] * img[t];
-					if (tmp > split)
-						components[x] = i, fitters[i].Add(img, w[x]);
-					else
-						fitters[nSplit].Add(img, w[x]);
-				}
-			}else{
-				for (int x = 0; x < cols; x++, img += D) {// for each pixel
-					if (components[x] != nSplit)
-						continue;
-					double tmp = 0;
-					for (int t = 0; t < D; t++)
-						tmp += sG.eVectors[t][0] * img[t];
-					if (tmp > split)
-						components[x] = i, fitters[i].Add(img);
-					else
-						fitters[nSplit].Add(img);
-				}
-			}
-		}
+		Fit(sampleDf, component1i, w1f, fitters, nSplit, i);
 
 		// Compute new split Gaussian
 		fitters[nSplit].BuildGuassian(_Guassians[nSplit], _sumW, true);
@@ -339,36 +440,21 @@ template <int D> void CmGMM_<D>::BuildGMMs(CMat& sampleDf, Mat& component1i, CMa
 	}
 	//for (int j = 0; j < _K; j++) printf("G%d = %g ", j, _Guassians[j].eValues[0]); printf("\n");
 	delete []fitters;
+	Prepare();
 }
 
 template <int D> int CmGMM_<D>::RefineGMMs(CMat& sampleDf, Mat& components1i, CMat& w1f, bool needReAssign)
 {
 	bool weighted = w1f.data != NULL;
-	int rows = sampleDf.rows, cols = sampleDf.cols; {
-		CV_Assert(sampleDf.data != NULL && sampleDf.type() == CV_MAKETYPE(CV_32F,D));
-		CV_Assert(!weighted || w1f.type() == CV_32FC1 && w1f.size == sampleDf.size);
-		if (sampleDf.isContinuous() && components1i.isContinuous() && (!weighted || w1f.isContinuous()))
-			cols *= sampleDf.rows, rows = 1;
-	}
+	CV_Assert(sampleDf.data != NULL && sampleDf.type() == CV_MAKETYPE(CV_32F,D));
+	CV_Assert(!weighted || w1f.type() == CV_32FC1 && w1f.size == sampleDf.size);
 
 	if (needReAssign)
 		AssignEachPixel(sampleDf, components1i);
 
 	// Relearn GMM from new component assignments
 	CmGaussianFitter<D>* fitters = new CmGaussianFitter<D>[_K];
-	for (int y = 0; y < rows; y++)	{
-		const float* pixel = sampleDf.ptr<float>(y);
-		const int* component = components1i.ptr<int>(y);
-		if (weighted){
-			const float* w = w1f.ptr<float>(y);
-			for (int x = 0; x < cols; x++, pixel += D)
-				fitters[component[x]].Add(pixel, w[x]);
-		}
-		else
-			for (int x = 0; x < cols; x++, pixel += D)
-				fitters[component[x]].Add(pixel);
-	}
-
+	Fit(sampleDf, components1i, w1f, fitters, -1, -1);
 
 	int newK = 0;
 	for (int i = 0; i < _K; i++)
@@ -376,6 +462,7 @@ template <int D> int CmGMM_<D>::RefineGMMs(CMat& sampleDf, Mat& components1i, CM
 			fitters[i].BuildGuassian(_Guassians[newK++], _sumW, false);
 	delete []fitters;
 	_K = newK;
+	Prepare();
 
 	// Assign each pixel
 	AssignEachPixel(sampleDf, components1i);
@@ -383,31 +470,87 @@ template <int D> int CmGMM_<D>::RefineGMMs(CMat& sampleDf, Mat& components1i, CM
 	return _K;
 }
 
-// this function is act as decoding
-template <int D> void CmGMM_<D>::AssignEachPixel(CMat& sampleDf, Mat &component1i)
+template <int D> void CmGMM_<D>::Fit(CMat& sampleDf, Mat& component1i, CMat& w1f,
+		CmGaussianFitter<D>* fitters, int nSplit, int newIdx)
 {
-	int rows = sampleDf.rows, cols = sampleDf.cols;
-	if (sampleDf.isContinuous() && component1i.isContinuous())
-		cols *= sampleDf.rows, rows = 1;
-
-	for (int y = 0; y < rows; y++)	{
-		const float* pixel = sampleDf.ptr<float>(y);
-		int* component = component1i.ptr<int>(y);
-		for (int x = 0; x < cols; x++, pixel += D)	{
-			int k = 0;
-			double maxP = 0;
-			//for each gaussian model, find the max,
-
-			for (int i = 0; i < _K; i++) {
-				double posb = P(i, pixel);
-				if (posb > maxP)
-					k = i, maxP = posb;
-			}
-			component[x] = k;
+	if (sampleDf.rows == 0)
+		return;
+	int stripes = min(sampleDf.rows, (int)FIT_STRIPES);
+	vector<CmGaussianFitter<D> > parts(stripes * _K);
+	CmGMMFitBody<D> body(sampleDf, component1i, w1f, _K, stripes, &parts[0]);
+	if (nSplit >= 0) {
+		// Splitting plane: through the mean, normal to the main eigenvector
+		const CmGaussian<D>& sG = _Guassians[nSplit];
+		double eVec[D], split = 0;
+		for (int t = 0; t < D; t++)
+			eVec[t] = sG.eVectors[t][0], split += eVec[t] * sG.mean[t];
+		body.setSplit(nSplit, newIdx, eVec, split);
+	}
+	parallel_for_(Range(0, stripes), body);
+	for (int s = 0; s < stripes; s++)
+		for (int k = 0; k < _K; k++)
+			fitters[k].Add(parts[s * _K + k]);
+}
+
+template <int D> void CmGMM_<D>::Prepare()
+{
+	_meanF.resize(_K * D);
+	_invF.resize(_K * D * D);
+	_logNormF.resize(_K);
+	_usable.resize(_K);
+	for (int k = 0; k < _K; k++) {
+		const CmGaussian<D>& g = _Guassians[k];
+		_usable[k] = g.w > 0 && g.det > 0;
+		if (!_usable[k])
+			continue;
+		for (int i = 0; i < D; i++) {
+			_meanF[k * D + i] = (float)g.mean[i];
+			for (int j = 0; j < D; j++)
+				_invF[(k * D + i) * D + j] = (float)g.inv[i][j];
 		}
+		_logNormF[k] = (float)g.logNorm;
 	}
 }
 
+template <int D> void CmGMM_<D>::RowDensities(const float *row, int n, Mat &soa1f, Mat &dens1f) const
+{
+	soa1f.create(D, n, CV_32F);
+	dens1f.create(_K, n, CV_32F);
+	const float* s[D];
+	for (int t = 0; t < D; t++) {
+		float* channel = soa1f.ptr<float>(t);
+		for (int x = 0; x < n; x++)
+			channel[x] = row[x * D + t];
+		s[t] = channel;
+	}
+	for (int k = 0; k < _K; k++) {
+		float* dens = dens1f.ptr<float>(k);
+		if (!_usable[k]) {
+			memset(dens, 0, n * sizeof(float));
+			continue;
+		}
+		const float *mean = &_meanF[k * D], *inv = &_invF[k * D * D];
+		float logNorm = _logNormF[k];
+		for (int x = 0; x < n; x++) {
+			float v[D], d = 0;
+			for (int t = 0; t < D; t++)
+				v[t] = s[t][x] - mean[t];
+			for (int i = 0; i < D; i++)
+				for (int j = 0; j < D; j++)
+					d += v[i] * inv[i * D + j] * v[j];
+			dens[x] = logNorm - 0.5f * d;
+		}
+		Mat logDens1f(1, n, CV_32F, dens);
+		cv::exp(logDens1f, logDens1f);
+	}
+}
+
+// this function is act as decoding
+template <int D> void CmGMM_<D>::AssignEachPixel(CMat& sampleDf, Mat &component1i)
+{
+	parallel_for_(Range(0, sampleDf.rows), CmGMMEvalBody<D>(*this, sampleDf, &component1i, NULL, NULL));
+}
+
 template <int D> Vec<float, D> CmGMM_<D>::getMean(int k) const {
 	CV_Assert(k >= 0 && k < _K);
 	Vec3f meanColor;
@@ -465,20 +608,15 @@ template <int D> bool CmGMM_<D>::Load(CStr &name)
 template <int D> void CmGMM_<D>::GetProbs(CMat sampleDf, vector<Mat> &pci) const
 {
 	pci.resize(_K);
-	Mat pI = Mat::zeros(sampleDf.size(), CV_32F);
-	for (int c = 0; c < _K; c++) {// for each component c
+	for (int c = 0; c < _K; c++) // for each component c
 		pci[c].create(sampleDf.size(), CV_32F);
-		for (int y = 0; y < sampleDf.rows; y++){
-			float* prob = pci[c].ptr<float>(y);
-			const float* sp = sampleDf.ptr<float>(y);
-			for (int x = 0; x < sampleDf.cols; x++, sp += D)
-				prob[x] = (float)P(c, sp);
-		}
-		add(pci[c], pI, pI);
-	}
+	parallel_for_(Range(0, sampleDf.rows), CmGMMEvalBody<D>(*this, sampleDf, NULL, &pci, NULL));
+}
 
-	for (int c = 0; c < _K; c++)
-		divide(pci[c], pI, pci[c]);
+template <int D> void CmGMM_<D>::GetMixture(CMat sampleDf, Mat &p1f) const
+{
+	p1f.create(sampleDf.size(), CV_32F);
+	parallel_for_(Range(0, sampleDf.rows), CmGMMEvalBody<D>(*this, sampleDf, NULL, NULL, &p1f));
 }
 
 template <int D> void CmGMM_<D>::iluProbs(CMat sampleDf, CStr &nameNE) const
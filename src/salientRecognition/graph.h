@@ -101,8 +101,14 @@ public:
 	// If the graph structure stays the same, then an alternative
 	// is to go through all nodes/edges and set new residual capacities
 	// (see functions below).
+	// The node, arc and search tree storage is kept for the next graph.
 	void reset();
 
+	// Makes room for node_num_max nodes and edge_num_max edges, so that
+	// add_node() and add_edge() do not reallocate. Only on an empty graph
+	// (new or after reset()), the storage never shrinks.
+	void reserve(int node_num_max, int edge_num_max);
+
 	////////////////////////////////////////////////////////////////////////////////
 	// 2. Functions for getting pointers to arcs and for reading graph structure. //
 	//    NOTE: adding new arcs may invalidate these pointers (if reallocation    //
@@ -493,14 +499,36 @@ template <typename captype, typename tcaptype, typename flowtype>
 
 	if (nodeptr_block)
 	{
-		delete nodeptr_block;
-		nodeptr_block = NULL;
+		nodeptr_block->Reset();
 	}
 
 	maxflow_iteration = 0;
 	flow = 0;
 }
 
+template <typename captype, typename tcaptype, typename flowtype>
+	void Graph<captype,tcaptype,flowtype>::reserve(int node_num_max, int edge_num_max)
+{
+	assert(node_num == 0 && arc_last == arcs);
+
+	if (node_max - nodes < node_num_max)
+	{
+		free(nodes);
+		nodes = (node*) malloc(node_num_max*sizeof(node));
+		if (!nodes) { if (error_function) (*error_function)("Not enough memory!"); exit(1); }
+		node_last = nodes;
+		node_max = nodes + node_num_max;
+	}
+	if (arc_max - arcs < 2*edge_num_max)
+	{
+		free(arcs);
+		arcs = (arc*) malloc(2*edge_num_max*sizeof(arc));
+		if (!arcs) { if (error_function) (*error_function)("Not enough memory!"); exit(1); }
+		arc_last = arcs;
+		arc_max = arcs + 2*edge_num_max;
+	}
+}
+
 template <typename captype, typename tcaptype, typename flowtype>
 	void Graph<captype,tcaptype,flowtype>::reallocate_nodes(int num)
 {
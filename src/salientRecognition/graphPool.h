@@ -0,0 +1,79 @@
+/*
+ * graphPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_GRAPHPOOL_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_GRAPHPOOL_H_
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include "graph.h"
+
+using namespace std;
+
+/*
+ * Hands out max-flow graphs whose node and arc storage is recycled across
+ * images. A released graph keeps its memory (see Graph::reset()), so after
+ * the first images a graph of the same size costs no allocation. At most
+ * one idle graph per hardware thread is kept, the others are deleted.
+ */
+template<class G> class GraphPool {
+public:
+	static GraphPool& instance() {
+		static GraphPool pool;
+		return pool;
+	}
+
+	/*an empty graph with room for nodeNum nodes and edgeNum edges*/
+	G* acquire(int nodeNum, int edgeNum) {
+		G* graph = NULL;
+		{
+			lock_guard<mutex> lock(mtx);
+			if (!idle.empty()) {
+				graph = idle.back();
+				idle.pop_back();
+			}
+		}
+		if (graph == NULL)
+			return new G(nodeNum, edgeNum);
+		graph->reset();
+		graph->reserve(nodeNum, edgeNum);
+		return graph;
+	}
+
+	void release(G* graph) {
+		if (graph == NULL)
+			return;
+		{
+			lock_guard<mutex> lock(mtx);
+			if (idle.size() < maxIdle) {
+				idle.push_back(graph);
+				return;
+			}
+		}
+		delete graph;
+	}
+
+	~GraphPool() {
+		for (unsigned int i = 0; i < idle.size(); i++) {
+			delete idle[i];
+		}
+	}
+
+private:
+	GraphPool() :
+			maxIdle(max(thread::hardware_concurrency(), 1u)) {
+	}
+	GraphPool(const GraphPool&);
+	GraphPool& operator=(const GraphPool&);
+
+	vector<G*> idle;
+	unsigned int maxIdle;
+	mutex mtx;
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_GRAPHPOOL_H_ */
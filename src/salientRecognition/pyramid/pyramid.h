@@ -26,6 +26,7 @@ public:
 	Mat reScale(Mat mat);
 	Rect reScale(Rect &rect);
 	Mat getOrigin();
+	int getScale();
 private:
 	Mat _origin;
 	Mat _final;
@@ -59,6 +60,13 @@ Mat Pyramid::getOrigin(){
 	return _origin;
 }
 
+/*
+ * number of pyrDown done by scale()
+ */
+int Pyramid::getScale(){
+	return _scale;
+}
+
 Mat Pyramid::reScale(Mat mat){
 	Mat res, mid = mat;
 	if(_scale==0)
@@ -11,10 +11,8 @@
 #include <opencv2/opencv.hpp>
 #include "opencv2/imgproc/types_c.h"
 #include "opencv2/imgproc/imgproc_c.h"
-#include <queue>
-#include <list>
-#include <set>
 #include <cstdlib>
+#include "spanFill.h"
 
 using namespace std;
 
@@ -23,25 +21,105 @@ const float CHOOSE_SIGN = 0.4;
 
 const Mat closeOpKernel(7, 7, CV_8U, cv::Scalar(1));
 
+/*
+ * SpanFill policies of RegionCut
+ */
+/*foreground pixels not in a connected region yet (flag -1), labeled id*/
+struct ForegroundFill {
+	ForegroundFill(Mat &img1f, Mat &flag): img1f(img1f), flag(flag), id(0){}
+	bool inside(int y, int x) const{
+		return img1f.ptr<float>(y)[x] > 0 && flag.ptr<int>(y)[x] == -1;
+	}
+	void fill(int y, int x0, int x1){
+		int *row = flag.ptr<int>(y);
+		std::fill(row + x0, row + x1, id);
+	}
+	Mat &img1f, &flag;
+	int id;
+};
+
+/*
+ * background pixels not reached yet (region 0), marked 1, and the
+ * foreground pixels 8-adjacent to them marked 3, as broadSearch did
+ */
+struct BackgroundFill {
+	BackgroundFill(Mat &img1f, Mat &region): img1f(img1f), region(region){}
+	bool inside(int y, int x) const{
+		return img1f.ptr<float>(y)[x] <= 0 && region.ptr<int>(y)[x] == 0;
+	}
+	void fill(int y, int x0, int x1){
+		int *row = region.ptr<int>(y);
+		std::fill(row + x0, row + x1, 1);
+		markForeground(y - 1, x0 - 1, x1 + 1);
+		markForeground(y, x0 - 1, x0);
+		markForeground(y, x1, x1 + 1);
+		markForeground(y + 1, x0 - 1, x1 + 1);
+	}
+	/*the foreground of [x0, x1) of row y, clipped to the image*/
+	void markForeground(int y, int x0, int x1){
+		if(y < 0 || y >= img1f.rows){
+			return;
+		}
+		const float *imgRow = img1f.ptr<float>(y);
+		int *row = region.ptr<int>(y);
+		for(int x = max(x0, 0); x < min(x1, img1f.cols); ++x){
+			if(imgRow[x] > 0){
+				row[x] = 3;
+			}
+		}
+	}
+	Mat &img1f, &region;
+};
+
+/*CANDIDATE_SIGN pixels, chosen in place (set to 1)*/
+struct CandidateFill {
+	CandidateFill(Mat &img1f): img1f(img1f){}
+	bool inside(int y, int x) const{
+		return abs(img1f.ptr<float>(y)[x] - CANDIDATE_SIGN) < 1e-6;
+	}
+	void fill(int y, int x0, int x1){
+		float *row = img1f.ptr<float>(y);
+		std::fill(row + x0, row + x1, 1.0f);
+	}
+	Mat &img1f;
+};
+
 class RegionCut{
 private:
 	typedef struct {
 			float pixelNum;
 			float centerX, centerY;
+			Rect bounds;
 		} ConnectRegion;
 
 	typedef struct { uchar r, g, b; } rgb;
 public:
 	RegionCut(float bgThreshold, float fgThreshold, bool debug = false);
 	Mat cut(Mat img1f, Mat regionImg1i);
+	/**
+	 * reentrant: the random seeds come from rng instead of rand()
+	 */
+	Mat cut(Mat img1f, Mat regionImg1i, RNG &rng);
 	void findConnectedRegion(Mat &img1f, Mat &flag, vector<ConnectRegion> &regionInfos);
 	void modifyRegion(Mat &img1f, Mat &flag, vector<ConnectRegion> &regionInfos);
 
+	/**
+	 * fills the holes of the foreground: the background not connected to
+	 * the image border. Returns the background that is (1 in the map).
+	 */
 	Mat findMainBorder(Mat &img1f);
+	/**
+	 * marks 1 in region the background of img1f connected to (x, y)
+	 */
 	void broadSearch(Mat &img1f, Mat &region, int y, int x);
+	/**
+	 * the seed of broadSearch: a seed already reached is skipped, a
+	 * foreground one still floods the background 8-adjacent to it
+	 */
+	void seedBackground(SpanFill &filler, BackgroundFill &background, Point seed);
 	bool isEmpty(Mat mat);
 	void fillInNonBorderRegion(Mat &img1f, Mat &region);
-	void floodCenterRegion(Mat &img1f);
+	void floodCenterRegion(Mat &img1f, RNG &rng);
 private:
 	float _bgThreshold;
 	float _fgThreshold;
@@ -71,26 +149,34 @@ bool RegionCut::isEmpty(Mat mat){
 }
 
 void RegionCut::fillInNonBorderRegion(Mat &img1f, Mat &region){
-	set<int> borderRegions;
 	int rows = img1f.rows;
 	int cols = img1f.cols;
+	double maxLabel = 0;
+	minMaxIdx(region, NULL, &maxLabel);
+	vector<uchar> borderRegions((int)maxLabel + 1, 0);
 	int *firstRow = region.ptr<int>(0);
 	int *lastRow = region.ptr<int>(rows - 1);
 	for(int x = 0; x < cols; ++x, ++firstRow, ++lastRow){
-		borderRegions.insert(*firstRow);
-		borderRegions.insert(*lastRow);
+		borderRegions[*firstRow] = 1;
+		borderRegions[*lastRow] = 1;
 	}
 	for(int y = 1; y < rows - 1; ++y){
-		borderRegions.insert(region.at<int>(y,0));
-		borderRegions.insert(region.at<int>(y, cols - 1));
+		borderRegions[region.at<int>(y,0)] = 1;
+		borderRegions[region.at<int>(y, cols - 1)] = 1;
 	}
+	// one lookup per span of the same segment
 	for(int y = 0; y < rows; ++y){
 		float *imgRow = img1f.ptr<float>(y);
 		int *regionRow = region.ptr<int>(y);
-		for(int x = 0; x < cols; ++x){
-			if(borderRegions.find(regionRow[x]) == borderRegions.end()){
-				imgRow[x] = CANDIDATE_SIGN;
+		for(int x = 0; x < cols;){
+			int end = x + 1;
+			while(end < cols && regionRow[end] == regionRow[x]){
+				++end;
 			}
+			if(!borderRegions[regionRow[x]]){
+				std::fill(imgRow + x, imgRow + end, CANDIDATE_SIGN);
+			}
+			x = end;
 		}
 	}
 	if(_debug){
@@ -99,57 +185,33 @@ void RegionCut::fillInNonBorderRegion(Mat &img1f, Mat &region){
 	}
 }
 
-void RegionCut::floodCenterRegion(Mat &img1f){
+void RegionCut::floodCenterRegion(Mat &img1f, RNG &rng){
 	int rows = img1f.rows;
 	int cols = img1f.cols;
-	queue<Point, list<Point> > queue;
+	SpanFill filler(img1f.size());
+	CandidateFill candidates(img1f);
 	//find a circle around the center, and random 10 point on it.
 	int centerX = cols / 2;
 	int centerY = rows / 2;
 	int radius = rows > cols ? centerX : centerY;
 	int diameter = radius * 2;
-	srand (time(NULL));
 	for(int i = 0; i < 10; ++i){
-		int randRow = (rand() % diameter) - radius;
-		int randCol = (rand() % diameter) - radius;
-		if(abs(img1f.at<float>(centerY + randRow, centerX + randCol) - CANDIDATE_SIGN) < 1e-6){
-			queue.push(Point(centerX + randRow, centerY + randCol));
-		}
+		int randRow = rng.uniform(0, diameter) - radius;
+		int randCol = rng.uniform(0, diameter) - radius;
+		filler.fill(candidates, Point(centerX + randCol, centerY + randRow));
 	}
 
 	Point start(cols / 2, rows / 2);
-	if(abs(img1f.at<float>(start.y, start.x) - CANDIDATE_SIGN) < 1e-6){
-		queue.push(start);
-	}
-	int direction[][2] = {
-			{1,0},
-			{1,1},
-			{1,-1},
-			{0,1},
-			{0,-1},
-			{-1,1},
-			{-1,0},
-			{-1,-1}
-	};
-	while(queue.size()){
-		Point pt = queue.front();
-		queue.pop();
-		img1f.at<float>(pt.y,pt.x) = 1;
-		for(int i = 0; i < 8; ++i){
-			int newX = pt.x + direction[i][0];
-			int newY = pt.y + direction[i][1];
-			if( newX >= 0 && newX < cols &&
-					newY && newY < rows &&
-					abs(img1f.at<float>(newY, newX) - CANDIDATE_SIGN) < 1e-6){
-				img1f.at<float>(newY, newX) = CHOOSE_SIGN;
-				queue.push(Point(newX, newY));
-			}
-		}
-	}
+	filler.fill(candidates, start);
 	threshold(img1f, img1f, CANDIDATE_SIGN + 0.1, 1, THRESH_BINARY);
 }
 
 Mat RegionCut::cut(Mat img1f, Mat regionImg1i){
+	RNG rng(time(NULL));
+	return cut(img1f, regionImg1i, rng);
+}
+
+Mat RegionCut::cut(Mat img1f, Mat regionImg1i, RNG &rng){
 	// 1) binarilization
 	threshold(img1f, img1f, _bgThreshold, 1, THRESH_BINARY);
 	// 1.5) if we found the image is totally black, we can run some heuristic algorithm
@@ -159,7 +221,7 @@ Mat RegionCut::cut(Mat img1f, Mat regionImg1i){
 	}
 	if(isEmpty(img1f)){
 		fillInNonBorderRegion(img1f, regionImg1i);
-		floodCenterRegion(img1f);
+		floodCenterRegion(img1f, rng);
 	}else{
 		// 2) get region connected map
 		vector<ConnectRegion> cRegions;
@@ -172,7 +234,7 @@ Mat RegionCut::cut(Mat img1f, Mat regionImg1i){
 
 		if(isEmpty(img1f)){
 			fillInNonBorderRegion(img1f, regionImg1i);
-			floodCenterRegion(img1f);
+			floodCenterRegion(img1f, rng);
 		}
 	}
 	return img1f;
@@ -226,9 +288,11 @@ Mat RegionCut::findMainBorder(Mat &img1f){
 	region = Scalar(0);
 
 	// find border and outside empty zone
+	SpanFill filler(img1f.size());
+	BackgroundFill background(img1f, region);
 	for(int x = 0; x < img1f.cols; ++x){
-		broadSearch(img1f, region, 0, x);
-		broadSearch(img1f, region, img1f.rows - 1, x);
+		seedBackground(filler, background, Point(x, 0));
+		seedBackground(filler, background, Point(x, img1f.rows - 1));
 	}
 	if(_debug){
 		Mat showRegion(region.size(), CV_32F);
@@ -244,8 +308,8 @@ Mat RegionCut::findMainBorder(Mat &img1f){
 
 	}
 	for(int y = 1; y < img1f.rows; ++y){
-		broadSearch(img1f, region, y, 0);
-		broadSearch(img1f, region, y, img1f.cols - 1);
+		seedBackground(filler, background, Point(0, y));
+		seedBackground(filler, background, Point(img1f.cols - 1, y));
 	}
 
 	if(_debug){
@@ -276,39 +340,28 @@ Mat RegionCut::findMainBorder(Mat &img1f){
 }
 
 void RegionCut::broadSearch(Mat &img1f, Mat &region, int y, int x){
-	if(region.at<int>(y,x) != 0){
+	SpanFill filler(img1f.size());
+	BackgroundFill background(img1f, region);
+	seedBackground(filler, background, Point(x, y));
+}
+
+void RegionCut::seedBackground(SpanFill &filler, BackgroundFill &background, Point seed){
+	Mat &img1f = background.img1f, &region = background.region;
+	if(region.at<int>(seed) != 0){
 		return;
 	}
-	queue<Point, list<Point> > queue;
-	queue.push(Point(x,y));
-	int rowNum = img1f.rows, colNum = img1f.cols;
-	while(queue.size()){
-		Point pt = queue.front();
-		queue.pop();
-		region.at<int>(pt.y, pt.x) = 2;
-		Point pointSet[] = {
-			Point(pt.x - 1, pt.y - 1),
-			Point(pt.x - 1, pt.y),
-			Point(pt.x - 1, pt.y + 1),
-			Point(pt.x, pt.y - 1),
-			Point(pt.x, pt.y + 1),
-			Point(pt.x + 1, pt.y - 1),
-			Point(pt.x + 1, pt.y),
-			Point(pt.x + 1, pt.y + 1),
-		};
-		for(int i = 0; i < 8; ++i){
-			Point *curPt = &pointSet[i];
-			if(curPt->x >= 0 && curPt->x < colNum &&
-					curPt->y >= 0 && curPt->y < rowNum){
-				if(img1f.at<float>(curPt->y, curPt->x) > 0){
-					region.at<int>(curPt->y, curPt->x) = 3;
-				}else{
-					if(region.at<int>(curPt->y, curPt->x) == 0){
-						region.at<int>(curPt->y, curPt->x) = 1;
-						queue.push(*curPt);
-					}
-				}
-			}
+	if(img1f.at<float>(seed) <= 0){
+		filler.fill(background, seed);
+		return;
+	}
+	// a foreground seed is not filled, the background around it is
+	region.at<int>(seed) = 2;
+	for(int y = seed.y - 1; y <= seed.y + 1; ++y){
+		background.markForeground(y, seed.x - 1, seed.x + 2);
+	}
+	for(int y = max(seed.y - 1, 0); y <= min(seed.y + 1, img1f.rows - 1); ++y){
+		for(int x = max(seed.x - 1, 0); x <= min(seed.x + 1, img1f.cols - 1); ++x){
+			filler.fill(background, Point(x, y));
 		}
 	}
 }
@@ -316,51 +369,23 @@ void RegionCut::broadSearch(Mat &img1f, Mat &region, int y, int x){
 void RegionCut::findConnectedRegion(Mat &img1f, Mat &flag, vector<ConnectRegion> &regionInfos){
 	flag.create(img1f.size(), 4);
 	flag = -1;
-	int regionIdx = 0;
+	SpanFill filler(img1f.size());
+	ForegroundFill foreground(img1f, flag);
+	float area = (float)img1f.cols * img1f.rows;
 	//find conn
 	for(int y = 0; y < img1f.rows; ++y){
-		int *flagRow = flag.ptr<int>(y);
+		const float *imgRow = img1f.ptr<float>(y);
+		const int *flagRow = flag.ptr<int>(y);
 		for(int x = 0; x < img1f.cols; ++x){
-			if(img1f.at<float>(y,x) > 0 && flag.at<int>(y,x) == -1){
-				int pixelNum = 0, centerX = 0, centerY = 0;
-				Point pt(x,y);
-				queue<Point, list<Point> > neighbors;
-				flagRow[x] = regionIdx;
-				neighbors.push(pt);
-
-				while(neighbors.size() > 0){
-					pt = neighbors.front();
-					neighbors.pop();
-					pixelNum += 1;
-					centerX += pt.x;
-					centerY += pt.y;
-
-					//find four direction
-					Point pointSet[] = {
-							Point(pt.x + 1, pt.y),
-							Point(pt.x, pt.y + 1),
-							Point(pt.x + 1, pt.y + 1),
-							Point(pt.x + 1, pt.y - 1),
-							Point(pt.x - 1, pt.y + 1),
-							Point(pt.x - 1, pt.y)
-					};
-					for(int i = 0; i < 6; ++i){
-						Point *checkPt = &pointSet[i];
-						if(checkPt->x < img1f.cols && checkPt->x >= 0 &&
-								checkPt->y >= 0 && checkPt->y < img1f.rows &&
-								img1f.at<float>(checkPt->y, checkPt->x) > 0 &&
-								flag.at<int>(checkPt->y, checkPt->x) == -1){
-							flag.at<int>(checkPt->y, checkPt->x) = regionIdx;
-							neighbors.push(*checkPt);
-						}
-					}
-				}
-
-				regionIdx++;
+			if(imgRow[x] > 0 && flagRow[x] == -1){
+				foreground.id = regionInfos.size();
+				SpanRegion region = filler.fill(foreground, Point(x, y));
+				Point2d center = region.centroid();
 				ConnectRegion newRegion;
-				newRegion.centerX = pixelNum / (float)img1f.cols;
-				newRegion.centerY = pixelNum / (float)img1f.rows;
-				newRegion.pixelNum = pixelNum / (float)img1f.cols / img1f.rows;
+				newRegion.centerX = center.x / img1f.cols;
+				newRegion.centerY = center.y / img1f.rows;
+				newRegion.pixelNum = region.area / area;
+				newRegion.bounds = region.bounds;
 				regionInfos.push_back(newRegion);
 			}
 		}
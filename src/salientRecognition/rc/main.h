@@ -41,13 +41,26 @@ template<class T> inline T pntSqrDist(const Point_<T> &p1, const Point_<T> &p2)
 
 typedef pair<float, int> CostfIdx;
 
-struct Region{
-		Region() { pixNum = 0; ad2c = Point2d(0, 0);}
-		int pixNum;  // Number of pixels
-		vector<CostfIdx> freIdx;  // Frequency of each color and its index
-		Point2d centroid;
-		Point2d ad2c; // Average distance to image center
-	};
+// Region i is pixNum[i], centroid[i], ad2c[i]; its colors are
+// freColor/fre[freStart[i] .. freStart[i+1]) (compressed rows)
+struct RegionTable{
+	RegionTable(int regNum = 0) { reset(regNum); }
+	void reset(int regNum){
+		pixNum.assign(regNum, 0);
+		centroid.assign(regNum, Point2d(0, 0));
+		ad2c.assign(regNum, Point2d(0, 0));
+		freStart.assign(regNum + 1, 0);
+		freColor.clear();
+		fre.clear();
+	}
+	int size() const { return (int)pixNum.size(); }
+	vector<int> pixNum;  // Number of pixels
+	vector<Point2d> centroid;
+	vector<Point2d> ad2c; // Average distance to image center
+	vector<int> freStart;
+	vector<int> freColor; // Index of each color
+	vector<float> fre;  // Frequency of each color
+};
 
 Point const DIRECTION8[9] = {
 	Point(1,  0), //Direction 0
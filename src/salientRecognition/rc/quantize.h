@@ -14,6 +14,7 @@
 #include "opencv2/imgproc/types_c.h"
 #include "opencv2/imgproc/imgproc_c.h"
 #include "main.h"
+#include "../../util/stageTimer.h"
 
 using namespace cv;
 using namespace std;
@@ -22,11 +23,12 @@ class Quantizer{
 public:
 	/**
 	 * quantize the color of image.
-	 * Mat &img3f:
+	 * Mat &img3f: CV_32FC3 image with values in [0, 1]
 	 */
 	int Quantize(Mat& img3f, Mat &idx1i, Mat &colorInfos3f, Mat &colorCount1i, double ratio = 0.95);
 private:
 	int getMaxColorNum(vector<pair<int, int> > &num, int rows, int cols, double ratio);
+	static void toBins(const float *imgData, int *idx, int cols, const float clrTmp[3], const int w[3]);
 private:
 	int clrNums[3] = {12,12,12};
 };
@@ -46,48 +48,64 @@ int Quantizer::getMaxColorNum(vector<pair<int, int> > &num, int rows, int cols,
 	return maxNum;
 }
 
+/**
+ * bin of each BGR pixel of a row. No branch and no lookup in the loop,
+ * so the compiler can vectorize it.
+ */
+void Quantizer::toBins(const float *imgData, int *idx, int cols, const float clrTmp[3], const int w[3]){
+	const float c0 = clrTmp[0], c1 = clrTmp[1], c2 = clrTmp[2];
+	const int w0 = w[0], w1 = w[1];
+	for(int x = 0; x < cols; ++x){
+		idx[x] = (int)(imgData[3 * x] * c0) * w0 + (int)(imgData[3 * x + 1] * c1) * w1 +
+				(int)(imgData[3 * x + 2] * c2);
+	}
+}
+
 int Quantizer::Quantize(Mat& img3f, Mat &idx1i, Mat &colorInfos3f, Mat &colorCount1i, double ratio){
+	static StageId stage("salient/quantize");
+	ScopedTimer timer(stage);
 
 	float clrTmp[3] = {clrNums[0] - 0.0001f, clrNums[1] - 0.0001f, clrNums[2] - 0.0001f};
 	int w[3] = {clrNums[1] * clrNums[2], clrNums[2], 1};
+	const int binNum = clrNums[0] * clrNums[1] * clrNums[2];
 
 	CV_Assert(img3f.data != NULL);
-	idx1i = Mat::zeros(img3f.size(), 4);
+	idx1i.create(img3f.size(), CV_32S);
 	int rows = img3f.rows, cols = img3f.cols;
 	if(img3f.isContinuous() && idx1i.isContinuous()){
 		cols *= rows;
 		rows = 1;
 	}
 
-	//store color into map
-	map<int, int> pallet;
-	//idx1i is used to store the hash key of each pixel
-	//pallet store the <hashkey, num> pair
+	//idx1i is used to store the bin (hash key) of each pixel,
+	//the bins are few (12^3), so they are counted in a plain array
 	for(int y = 0; y < rows; ++y){
-		//TODO change from float to uchar
-		const float * imgData = img3f.ptr<float>(y);
-		int *idx = idx1i.ptr<int>(y);
-		for(int x = 0; x < cols; ++x, imgData += 3){
-			idx[x] = (int)(imgData[0] * clrTmp[0]) * w[0] + (int)(imgData[1] * clrTmp[1]) * w[1] +
-					(int)(imgData[2] * clrTmp[2]);
-			++pallet[idx[x]];
+		toBins(img3f.ptr<float>(y), idx1i.ptr<int>(y), cols, clrTmp, w);
+	}
+	vector<int> hist(binNum, 0);
+	for(int y = 0; y < rows; ++y){
+		const int *idx = idx1i.ptr<int>(y);
+		for(int x = 0; x < cols; ++x){
+			++hist[idx[x]];
 		}
 	}
 	int maxNum = 0;
+	// lut maps a bin to its palette idx
+	vector<int> lut(binNum, -1);
 	{
 		vector<pair<int, int> > num;
-		num.reserve(pallet.size());
-		//reverse the pair to <num, hashkey>
-		for(map<int, int>::iterator it = pallet.begin(); it != pallet.end(); ++it){
-			num.push_back(pair<int, int>(it->second, it->first));
+		//<num, hashkey> of the bins in use
+		for(int i = 0; i < binNum; ++i){
+			if(hist[i] > 0){
+				num.push_back(pair<int, int>(hist[i], i));
+			}
 		}
 		sort(num.begin(), num.end(), std::greater<pair<int, int> >());
 		maxNum = getMaxColorNum(num, rows, cols, ratio);
-		pallet.clear();
-		// pallet stores <hashkey, idx> and idx is in the desc order.
+		// the palette idx is in the desc order.
 		// the less the idx, the higher the number.
 		for(int i = 0; i < maxNum; ++i){
-			pallet[num[i].second] = i;
+			lut[num[i].second] = i;
 		}
 
 		// restore the color
@@ -98,8 +116,7 @@ int Quantizer::Quantize(Mat& img3f, Mat &idx1i, Mat &colorInfos3f, Mat &colorCou
 			color3i[i][2] = num[i].second % w[1];
 		}
 
-		//cal distance
-		// pallet store <hashkey, hashkey> second is the smallest distance between first
+		//the rare colors take the palette idx of the nearest kept color
 		for(unsigned int i = maxNum; i < num.size(); ++i){
 			int simIdx = 0, simVal = INT_MAX;
 			//find min distance vec
@@ -109,7 +126,7 @@ int Quantizer::Quantize(Mat& img3f, Mat &idx1i, Mat &colorInfos3f, Mat &colorCou
 					simVal = d_ij, simIdx = j;
 				}
 			}
-			pallet[num[i].second] = pallet[num[simIdx].second];
+			lut[num[i].second] = simIdx;
 		}
 	}
 
@@ -124,9 +141,8 @@ int Quantizer::Quantize(Mat& img3f, Mat &idx1i, Mat &colorInfos3f, Mat &colorCou
 		//hashkey data
 		int *idx = idx1i.ptr<int>(y);
 		for(int x = 0; x < cols; ++x){
-			//set idx1i as the nearest hashkey
-			idx[x] = pallet[idx[x]];
-			//??
+			//set idx1i as the palette idx of its bin
+			idx[x] = lut[idx[x]];
 			color[idx[x]] += imgData[x];
 			colorNum[idx[x]]++;
 		}
@@ -19,19 +19,19 @@
 class RegionContrastSalient{
 public:
 	RegionContrastSalient(double sigmaDist = 0.4, float regionWeight = 2, float distanceWeight = 0.01, bool debug = false);
-	void BuildRegions(Mat& regionIdxImage, vector<Region> &regionInfos, Mat &colorIdxImage, int colorNum);
-	void RegionContrast(const vector<Region> &regionInfos, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f);
-	void RegionContrast2(const vector<Region> &regionInfos, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f);
-	Mat GetBorderReg(Mat &regionIdxImage, int regNum, double ratio, double thr);
+	void BuildRegions(Mat& regionIdxImage, RegionTable &regions, Mat &colorIdxImage, int colorNum);
+	void RegionContrast(const RegionTable &regions, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f);
+	void RegionContrast2(const RegionTable &regions, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f);
+	Mat GetBorderReg(Mat &regionIdxImage, const RegionTable &regions, double ratio, double thr);
 	void SmoothSaliency(Mat &colorCount1i, Mat &colorSalientScore1d, float delta, const vector<vector<CostfIdx> > &similiarMatrix);
 	void SmoothByHist(Mat &originImage3f, Mat &salientScoreImage1f, float delta);
-	void SmoothByRegion(Mat &sal1f, Mat &segIdx1i, int regNum, bool bNormalize = true);
+	void SmoothByRegion(Mat &sal1f, Mat &segIdx1i, const RegionTable &regions, bool bNormalize = true);
 
 	Mat getRC(Mat &img3f, Mat &regionIdxImage1i, int regNum, double sigmaDist, bool debug= false);
 	Mat equalize(Mat &img);
 
 	Mat centerRC(
-			vector<Region> region,
+			const RegionTable &regions,
 			Mat &regionColor,
 			Mat &regionScore,
 			double sigmaDist,
@@ -42,7 +42,7 @@ public:
 			);
 
 	Mat originRC(
-			vector<Region> regions,
+			const RegionTable &regions,
 			Mat &regionColor,
 			Mat &regionScore,
 			double sigmaDist,
@@ -52,7 +52,7 @@ public:
 			bool debug= false
 			);
 
-	Mat hardHC(vector<Region> regions,
+	Mat hardHC(const RegionTable &regions,
 			Mat &regionColor,
 			Mat &regionScore,
 			double sigmaDist,
@@ -86,9 +86,12 @@ RegionContrastSalient::RegionContrastSalient(double sigmaDist, float regionWeigh
 
 }
 
-void RegionContrastSalient::BuildRegions(Mat& regionIdxImage, vector<Region> &regionInfos, Mat &colorIdxImage, int colorNum)
+void RegionContrastSalient::BuildRegions(Mat& regionIdxImage, RegionTable &regions, Mat &colorIdxImage, int colorNum)
 {
-	int rows = regionIdxImage.rows, cols = regionIdxImage.cols, regNum = (int)regionInfos.size();
+	int rows = regionIdxImage.rows, cols = regionIdxImage.cols, regNum = regions.size();
+	regions.reset(regNum);
+	int *pixNum = &regions.pixNum[0];
+	Point2d *centroid = &regions.centroid[0], *ad2c = &regions.ad2c[0];
 	//center
 	double cx = cols/2.0, cy = rows / 2.0;
 	// build region color frequency
@@ -98,27 +101,28 @@ void RegionContrastSalient::BuildRegions(Mat& regionIdxImage, vector<Region> &re
 		const int *regIdx = regionIdxImage.ptr<int>(y);
 		const int *colorIdx = colorIdxImage.ptr<int>(y);
 		for (int x = 0; x < cols; x++, regIdx++, colorIdx++){
-			Region &reg = regionInfos[*regIdx];
-			reg.pixNum ++;
-			reg.centroid.x += x;
-			reg.centroid.y += y;
-			regColorFre1i(*regIdx, *colorIdx)++;
-			reg.ad2c += Point2d(abs(x - cx), abs(y - cy));
+			int i = *regIdx;
+			pixNum[i] ++;
+			centroid[i].x += x;
+			centroid[i].y += y;
+			regColorFre1i(i, *colorIdx)++;
+			ad2c[i] += Point2d(abs(x - cx), abs(y - cy));
 		}
 	}
 	// all the information has normalized to [0,1)
 	for (int i = 0; i < regNum; i++){
-		Region &reg = regionInfos[i];
-		reg.centroid.x /= reg.pixNum * cols;
-		reg.centroid.y /= reg.pixNum * rows;
-		reg.ad2c.x /= reg.pixNum * cols;
-		reg.ad2c.y /= reg.pixNum * rows;
+		centroid[i].x /= pixNum[i] * cols;
+		centroid[i].y /= pixNum[i] * rows;
+		ad2c[i].x /= pixNum[i] * cols;
+		ad2c[i].y /= pixNum[i] * rows;
 		int *regColorFre = regColorFre1i.ptr<int>(i);
 		for (int j = 0; j < colorNum; j++){
-			float fre = (float)regColorFre[j]/(float)reg.pixNum;
-			if (regColorFre[j] > EPS)
-				reg.freIdx.push_back(make_pair(fre, j));
+			if (regColorFre[j] > EPS){
+				regions.freColor.push_back(j);
+				regions.fre.push_back((float)regColorFre[j]/(float)pixNum[i]);
+			}
 		}
+		regions.freStart[i + 1] = (int)regions.fre.size();
 	}
 }
 
@@ -135,127 +139,166 @@ Mat_<float> pairwiseColorDist(Mat &colorInfos){
 	return cDistCache1f;
 }
 
-void RegionContrastSalient::RegionContrast2(const vector<Region> &regionInfos, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f){
+void RegionContrastSalient::RegionContrast2(const RegionTable &regions, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta, Mat_<float> &cDistCache1f){
 	int i;
-	int regNum = (int)regionInfos.size();
+	int regNum = regions.size();
+	const int *freStart = &regions.freStart[0], *freColor = regions.freColor.empty() ? NULL : &regions.freColor[0];
+	const float *fre = regions.fre.empty() ? NULL : &regions.fre[0];
 //	Mat_<float> cDistCache1f = pairwiseColorDist(colorInfos);
 
 	Mat_<double> rDistCache1d = Mat::zeros(regNum, regNum, CV_64F);
 	regionSalientScore = Mat::zeros(1, regNum, CV_64F);
 	double* regSal = (double*)regionSalientScore.data;
 	for (i = 0; i < regNum; i++){
-		const Point2d &rc = regionInfos[i].centroid;
+		const Point2d &rc = regions.centroid[i];
 		for (int j = 0; j < regNum; j++){
 			if(i<j) {
 				double dd = 0;
-				const vector<CostfIdx> &c1 = regionInfos[i].freIdx, &c2 = regionInfos[j].freIdx;
-				for (size_t m = 0; m < c1.size(); m++){
-					for (size_t n = 0; n < c2.size(); n++){
-						dd += cDistCache1f[c1[m].second][c2[n].second] * c1[m].first * c2[n].first;
+				for (int m = freStart[i]; m < freStart[i + 1]; m++){
+					for (int n = freStart[j]; n < freStart[j + 1]; n++){
+						dd += cDistCache1f[freColor[m]][freColor[n]] * fre[m] * fre[n];
 					}
 				}
-				rDistCache1d[j][i] = rDistCache1d[i][j] = dd * exp(-pntSqrDist(rc, regionInfos[j].centroid)/_sigmaDist);
+				rDistCache1d[j][i] = rDistCache1d[i][j] = dd * exp(-pntSqrDist(rc, regions.centroid[j])/_sigmaDist);
 			}
-			regSal[i] += regionInfos[j].pixNum * rDistCache1d[i][j];
+			regSal[i] += regions.pixNum[j] * rDistCache1d[i][j];
 		}
-		regSal[i] *= exp(_regionWeight * sqrt(regionInfos[i].pixNum / (float)pixelNum) - _distanceWeight * (sqr(regionInfos[i].ad2c.x) + sqr(regionInfos[i].ad2c.y)));
+		regSal[i] *= exp(_regionWeight * sqrt(regions.pixNum[i] / (float)pixelNum) - _distanceWeight * (sqr(regions.ad2c[i].x) + sqr(regions.ad2c[i].y)));
 	}
 }
 
+/*
+ * Sum over j of w(rj) * Dr(ri,rj) * exp(-Ds(ri,rj)^2/sigmaDist) for every
+ * region i, the contrast part of RegionContrast.
+ * Dr(ri,rj) = fi' D fj with fi the color frequencies of ri and D the color
+ * distances: G = F D is computed once for all regions (a matrix product),
+ * then Dr(ri,rj) only walks the colors of rj.
+ * Every pair is weighted: with the sigmaDist in use (0.4) the spatial weight
+ * of two centroids in [0,1)^2 never gets negligible, so no pair can be
+ * skipped. The regions are split between threads.
+ */
+class RegionContrastBody : public ParallelLoopBody {
+public:
+	RegionContrastBody(const RegionTable &regions, const Mat_<float> &cDistCache1f,
+			double sigmaDist, double *regSal)
+	: regions(regions), sigmaDist(sigmaDist), regSal(regSal){
+		int regNum = regions.size(), colorNum = cDistCache1f.cols;
+		Mat_<double> fre1d = Mat_<double>::zeros(regNum, colorNum);
+		for(int i = 0; i < regNum; ++i){
+			for(int n = regions.freStart[i]; n < regions.freStart[i + 1]; ++n){
+				fre1d(i, regions.freColor[n]) = regions.fre[n];
+			}
+		}
+		Mat cDist1d;
+		cDistCache1f.convertTo(cDist1d, CV_64F);
+		gemm(fre1d, cDist1d, 1, noArray(), 0, g1d);
+	}
+
+	void operator()(const Range &range) const {
+		const Point2d *centroid = &regions.centroid[0];
+		const int *pixNum = &regions.pixNum[0], *freStart = &regions.freStart[0];
+		const int *freColor = &regions.freColor[0];
+		const float *fre = &regions.fre[0];
+		int regNum = regions.size();
+		for(int i = range.start; i < range.end; ++i){
+			const Point2d &rc = centroid[i];
+			const double *g = g1d.ptr<double>(i);
+			double sal = 0;
+			for(int j = 0; j < regNum; ++j){
+				if(j == i){
+					continue;
+				}
+				// color distance * frequency
+				double dd = 0;
+				for(int n = freStart[j]; n < freStart[j + 1]; ++n){
+					dd += g[freColor[n]] * fre[n];
+				}
+				// Dr(rk,ri) * exp(Ds(rk,ri)/-sigmas^2), then * w(ri)
+				sal += pixNum[j] * dd * exp(-pntSqrDist(rc, centroid[j]) / sigmaDist);
+			}
+			regSal[i] = sal;
+		}
+	}
+
+private:
+	const RegionTable &regions;
+	double sigmaDist;
+	double *regSal;
+	Mat_<double> g1d;
+};
+
 void RegionContrastSalient::RegionContrast(
-		const vector<Region> &regionInfos, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta,
+		const RegionTable &regions, Mat &colorInfos, Mat& regionSalientScore, int pixelNum, float theta,
 		Mat_<float> &cDistCache1f)
 {
 	int i,len;
-	int regNum = (int)regionInfos.size();
+	int regNum = regions.size();
 	if(_debug){
 		//cout << "when theta=" << theta << endl;
 		int mu = 0,sigma = 0;
 		for(i = 0; i < regNum; ++i){
-			mu += regionInfos[i].pixNum;
+			mu += regions.pixNum[i];
 		}
 		mu /= regNum;
 		for(i = 0; i < regNum; ++i){
-			sigma = sqr(mu - regionInfos[i].pixNum);
+			sigma = sqr(mu - regions.pixNum[i]);
 		}
 		//cout << (mu / (float)pixelNum) << "," << (sqrt(sigma) / (float)pixelNum) << "," << regNum << endl;
 	}
 	//calculate the distance between any pair of color set.
-
-
-	Mat_<double> rDistCache1d = Mat::zeros(regNum, regNum, CV_64F);
 	regionSalientScore = Mat::zeros(1, regNum, CV_64F);
 	double* regSal = (double*)regionSalientScore.data;
+	RegionContrastBody body(regions, cDistCache1f, _sigmaDist, regSal);
+	parallel_for_(Range(0, regNum), body);
 	for (i = 0; i < regNum; i++){
-		const Point2d &rc = regionInfos[i].centroid;
-		for (int j = 0; j < regNum; j++){
-			if(i<j) {
-				double dd = 0;
-				// probability of each kind of color pixel
-				const vector<CostfIdx> &c1 = regionInfos[i].freIdx, &c2 = regionInfos[j].freIdx;
-				for (size_t m = 0; m < c1.size(); m++){
-					for (size_t n = 0; n < c2.size(); n++){
-						// color distance * frequency
-						dd += cDistCache1f[c1[m].second][c2[n].second] * c1[m].first * c2[n].first;
-					}
-				}
-				// Dr(rk,ri) * exp(Ds(rk,ri)/-sigmas^2)
-				rDistCache1d[j][i] = rDistCache1d[i][j] = dd * exp(-pntSqrDist(rc, regionInfos[j].centroid)/_sigmaDist);
-			}
-			//then * w(ri)
-			regSal[i] += regionInfos[j].pixNum * rDistCache1d[i][j];
-		}
+		const Point2d &ad2c = regions.ad2c[i];
 		// then * exp(-9dk^2)
 		if(theta > 0){
-			regSal[i] *= exp(-15.0 * (sqr(regionInfos[i].ad2c.x) + sqr(regionInfos[i].ad2c.y)));
+			regSal[i] *= exp(-15.0 * (sqr(ad2c.x) + sqr(ad2c.y)));
 		}else{
-			regSal[i] *= exp(-12.0 * (sqr(regionInfos[i].ad2c.x) + sqr(regionInfos[i].ad2c.y)));
+			regSal[i] *= exp(-12.0 * (sqr(ad2c.x) + sqr(ad2c.y)));
 		}
 //		regSal[i] /= regs[i].pixNum * sqrt(sqr(0.5 - regs[i].centroid.y) + sqr(0.5 - regs[i].centroid.x)) / 150;
 //		regSal[i] *= sqrt(exp(regs[i].pixNum / pixelNum - sqrt(sqr(0.5 - regs[i].centroid.y) + sqr(0.5 - regs[i].centroid.x))) / 100 );
 
 		//should be reserved
 		if(theta > 0){
-			double prior = exp( sqrt(regionInfos[i].pixNum * 2 / (float)pixelNum) -
-					sqrt(sqr(regionInfos[i].ad2c.x) + sqr(regionInfos[i].ad2c.y))
+			double prior = exp( sqrt(regions.pixNum[i] * 2 / (float)pixelNum) -
+					sqrt(sqr(ad2c.x) + sqr(ad2c.y))
 					/ theta );
 			regSal[i] *= prior;
 			if(_debug){
-				cout << "region " << i << "[" << regionInfos[i].pixNum << "]:" << prior << endl;
+				cout << "region " << i << "[" << regions.pixNum[i] << "]:" << prior << endl;
 			}
 		}
 	}
 
 	if(_debug){
 		vector<pair<int, double> > debugRegions;
-		len = (int)regionInfos.size();
+		len = regNum;
 		for(i = 0; i < len; ++i){
 			debugRegions.push_back(make_pair(i, regSal[i]));
 		}
 		sort(debugRegions.begin(), debugRegions.end(), region_cmp);
 		for(i = 0, len = debugRegions.size(); i < len; ++i){
 			int idx = debugRegions[i].first;
-			cout << "region " << idx << "[" << regionInfos[idx].centroid <<"]["<< regionInfos[idx].pixNum << "]: " << regSal[idx] << endl;
+			cout << "region " << idx << "[" << regions.centroid[idx] <<"]["<< regions.pixNum[idx] << "]: " << regSal[idx] << endl;
 		}
 	}
 }
 
-Mat RegionContrastSalient::GetBorderReg(Mat &regionIdxImage, int regNum, double ratio, double thr)
+Mat RegionContrastSalient::GetBorderReg(Mat &regionIdxImage, const RegionTable &regions, double ratio, double thr)
 {
+	int regNum = regions.size();
 	// Variance of x and y
 	vecD vX(regNum), vY(regNum);
 	int w = regionIdxImage.cols, h = regionIdxImage.rows;
 	{
-		vecD mX(regNum), mY(regNum), n(regNum); // Mean value of x and y, pixel number of region
-		// collect the x,y coordinate and number of each region
-		for (int y = 0; y < regionIdxImage.rows; y++){
-			const int *idx = regionIdxImage.ptr<int>(y);
-			for (int x = 0; x < regionIdxImage.cols; x++, idx++)
-				mX[*idx] += x, mY[*idx] += y, n[*idx]++;
-		}
-		// calculate average x,y
+		// Mean value of x and y (the centroids), pixel number of region
+		vecD mX(regNum), mY(regNum);
+		const int *n = &regions.pixNum[0];
 		for (int i = 0; i < regNum; i++)
-			mX[i] /= n[i], mY[i] /= n[i];
+			mX[i] = regions.centroid[i].x * w, mY[i] = regions.centroid[i].y * h;
 		// cal abs of variance from each axis
 		for (int y = 0; y < regionIdxImage.rows; y++){
 			const int *idx = regionIdxImage.ptr<int>(y);
@@ -397,21 +440,19 @@ void RegionContrastSalient::SmoothByHist(Mat &originImage3f, Mat &salientScoreIm
 	}
 }
 
-void RegionContrastSalient::SmoothByRegion(Mat &sal1f, Mat &segIdx1i, int regNum, bool bNormalize)
+void RegionContrastSalient::SmoothByRegion(Mat &sal1f, Mat &segIdx1i, const RegionTable &regions, bool bNormalize)
 {
+	int regNum = regions.size();
 	vecD saliecy(regNum, 0);
-	vecI counter(regNum, 0);
 	for (int y = 0; y < sal1f.rows; y++){
 		const int *idx = segIdx1i.ptr<int>(y);
 		float *sal = sal1f.ptr<float>(y);
-		for (int x = 0; x < sal1f.cols; x++){
+		for (int x = 0; x < sal1f.cols; x++)
 			saliecy[idx[x]] += sal[x];
-			counter[idx[x]] ++;
-		}
 	}
 
-	for (size_t i = 0; i < counter.size(); i++)
-		saliecy[i] /= counter[i];
+	for (int i = 0; i < regNum; i++)
+		saliecy[i] /= regions.pixNum[i];
 	Mat rSal(1, regNum, CV_64FC1, &saliecy[0]);
 	if (bNormalize)
 		normalize(rSal, rSal, 0, 1, NORM_MINMAX);
@@ -426,20 +467,20 @@ void RegionContrastSalient::SmoothByRegion(Mat &sal1f, Mat &segIdx1i, int regNum
 
 
 
-Mat RegionContrastSalient::hardHC(vector<Region> regions,
+Mat RegionContrastSalient::hardHC(const RegionTable &regions,
 		Mat &regionColor,
 		Mat &regionScore,
 		double sigmaDist,
 		Mat &originImage,
 		Mat regionIdxImage, bool debug
 		){
-	int regNum = (int)regions.size();
+	int regNum = regions.size();
 	int pixelNum = originImage.rows * originImage.cols;
 	regionScore = Mat::zeros(1, regNum, CV_64F);
 	double* regSal = (double*)regionScore.data;
 	for(int i = 0; i < regNum; ++i){
-		regSal[i] = exp( sqrt(regions[i].pixNum * 2 / (float)pixelNum) -
-				sqrt(sqr(regions[i].ad2c.x) + sqr(regions[i].ad2c.y))
+		regSal[i] = exp( sqrt(regions.pixNum[i] * 2 / (float)pixelNum) -
+				sqrt(sqr(regions.ad2c[i].x) + sqr(regions.ad2c[i].y))
 				/ 10 );
 	}
 	int maxIter = 0;
@@ -469,10 +510,9 @@ Mat RegionContrastSalient::hardHC(vector<Region> regions,
 	return sal1f;
 }
 
-Mat RegionContrastSalient::originRC(vector<Region> regions, Mat &regionColor, Mat &regionScore, double sigmaDist, Mat &originImage3f, Mat regionIdxImage, Mat_<float> &cDistCache1f, bool debug){
+Mat RegionContrastSalient::originRC(const RegionTable &regions, Mat &regionColor, Mat &regionScore, double sigmaDist, Mat &originImage3f, Mat regionIdxImage, Mat_<float> &cDistCache1f, bool debug){
 	RegionContrast(regions, regionColor, regionScore,
 			originImage3f.rows * originImage3f.cols, 0, cDistCache1f);
-	int regNum = (int)regions.size();
 	Mat salientScoreImage1f = Mat::zeros(originImage3f.size(), CV_32F);
 	if(debug){
 		printMat<double>(regionScore);
@@ -490,20 +530,19 @@ Mat RegionContrastSalient::originRC(vector<Region> regions, Mat &regionColor, Ma
 			sal[c] = saturate_cast<float>(regSal[regIdx[c]]);
 		}
 	}
-	Mat borderRegion1u = GetBorderReg(regionIdxImage, regNum, 0.02, 0.4);
+	Mat borderRegion1u = GetBorderReg(regionIdxImage, regions, 0.02, 0.4);
 	salientScoreImage1f.setTo(0, borderRegion1u);
 	SmoothByHist(originImage3f, salientScoreImage1f, 0.1f);
-	SmoothByRegion(salientScoreImage1f, regionIdxImage, regNum);
+	SmoothByRegion(salientScoreImage1f, regionIdxImage, regions);
 	salientScoreImage1f.setTo(0, borderRegion1u);
 //	GaussianBlur(salientScoreImage1f, salientScoreImage1f, Size(3,3), 0);
 	normalize(salientScoreImage1f, salientScoreImage1f, 0, 1, NORM_MINMAX);
 	return salientScoreImage1f;
 }
 
-Mat RegionContrastSalient::centerRC(vector<Region> regions, Mat &regionColor, Mat &regionScore, double sigmaDist, Mat &originImage, Mat regionIdxImage, Mat_<float> &cDistCache1f, bool debug){
+Mat RegionContrastSalient::centerRC(const RegionTable &regions, Mat &regionColor, Mat &regionScore, double sigmaDist, Mat &originImage, Mat regionIdxImage, Mat_<float> &cDistCache1f, bool debug){
 	RegionContrast(regions, regionColor, regionScore,
 			originImage.rows * originImage.cols, 15, cDistCache1f);
-	int regNum = (int)regions.size();
 	Mat sal1f = Mat::zeros(originImage.size(), CV_32F);
 	if(debug){
 		printMat<double>(regionScore);
@@ -520,10 +559,10 @@ Mat RegionContrastSalient::centerRC(vector<Region> regions, Mat &regionColor, Ma
 			sal[c] = saturate_cast<float>(regSal[regIdx[c]]);
 		}
 	}
-	Mat bdReg1u = GetBorderReg(regionIdxImage, regNum, 0.02, 0.4);
+	Mat bdReg1u = GetBorderReg(regionIdxImage, regions, 0.02, 0.4);
 	sal1f.setTo(0, bdReg1u);
 	SmoothByHist(originImage, sal1f, 0.1f);
-	SmoothByRegion(sal1f, regionIdxImage, regNum);
+	SmoothByRegion(sal1f, regionIdxImage, regions);
 	sal1f.setTo(0, bdReg1u);
 //	GaussianBlur(sal1f, sal1f, Size(3,3), 0);
 	normalize(sal1f, sal1f, 0, 1, NORM_MINMAX);
@@ -542,6 +581,8 @@ Mat RegionContrastSalient::equalize(Mat &img){
 }
 
 Mat RegionContrastSalient::getRC(Mat &img3f, Mat &regionIdxImage1i, int regNum, double sigmaDist, bool debug){
+	static StageId stage("salient/rc");
+	ScopedTimer timer(stage);
 	//quantize
 	Mat colorIdx1i, regSal1v, tmp, color3fv;
 	img3f.convertTo(img3f, CV_32FC3, 1.0/255);
@@ -561,7 +602,7 @@ Mat RegionContrastSalient::getRC(Mat &img3f, Mat &regionIdxImage1i, int regNum,
 	}
 
 	cvtColor(color3fv, color3fv, CV_BGR2Lab);
-	vector<Region> regs(regNum);
+	RegionTable regs(regNum);
 
 	BuildRegions(regionIdxImage1i, regs, colorIdx1i, color3fv.cols);
 	Mat_<float> cDistCache1f = pairwiseColorDist(color3fv);
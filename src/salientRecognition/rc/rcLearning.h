@@ -42,7 +42,7 @@ void rcLearning::rcTraining(Mat &input, Mat &seg, int segNum, vector<int> salien
 	quantizer.Quantize(input, colorIdx1i, color3fv, tmp);
 
 	cvtColor(color3fv, color3fv, CV_BGR2Lab);
-	vector<Region> regs(segNum);
+	RegionTable regs(segNum);
 
 	rcs.BuildRegions(seg, regs, colorIdx1i, color3fv.cols);
 	Mat_<float> cDistCache1f = pairwiseColorDist(color3fv);
@@ -51,19 +51,18 @@ void rcLearning::rcTraining(Mat &input, Mat &seg, int segNum, vector<int> salien
 	Mat regionSalientScore = Mat::zeros(1, segNum, CV_64F);
 	double* regSal = (double*)regionSalientScore.data;
 	for (int i = 0; i < segNum; i++){
-		const Point2d &rc = regs[i].centroid;
+		const Point2d &rc = regs.centroid[i];
 		for (int j = 0; j < segNum; j++){
 			if(i<j) {
 				double dd = 0;
-				const vector<CostfIdx> &c1 = regs[i].freIdx, &c2 = regs[j].freIdx;
-				for (size_t m = 0; m < c1.size(); m++){
-					for (size_t n = 0; n < c2.size(); n++){
-						dd += cDistCache1f[c1[m].second][c2[n].second] * c1[m].first * c2[n].first;
+				for (int m = regs.freStart[i]; m < regs.freStart[i + 1]; m++){
+					for (int n = regs.freStart[j]; n < regs.freStart[j + 1]; n++){
+						dd += cDistCache1f[regs.freColor[m]][regs.freColor[n]] * regs.fre[m] * regs.fre[n];
 					}
 				}
-				rDistCache1d[j][i] = rDistCache1d[i][j] = dd * exp(-pntSqrDist(rc, regs[j].centroid)/rcs.getSigmaDist());
+				rDistCache1d[j][i] = rDistCache1d[i][j] = dd * exp(-pntSqrDist(rc, regs.centroid[j])/rcs.getSigmaDist());
 			}
-			regSal[i] += regs[j].pixNum * rDistCache1d[i][j];
+			regSal[i] += regs.pixNum[j] * rDistCache1d[i][j];
 		}
 //		regSal[i] *= exp(_regionWeight * sqrt(regs[i].pixNum / (float)pixelNum) - _distanceWeight * (sqr(regs[i].ad2c.x) + sqr(regs[i].ad2c.y)));
 	}
@@ -71,10 +70,10 @@ void rcLearning::rcTraining(Mat &input, Mat &seg, int segNum, vector<int> salien
 	float pixelNum = input.rows * input.cols;
 	for(unsigned i = 0, ilen = salientIdices.size(); i < ilen; ++i){
 		for(unsigned j = 0, jlen = nonSalientIdices.size(); j < jlen; ++j){
-			double regionScoreI = sqrt(regs[i].pixNum / pixelNum);
-			double regionScoreJ = sqrt(regs[j].pixNum / pixelNum);
-			double distScoreI = sqr(regs[i].ad2c.x) + sqr(regs[i].ad2c.y);
-			double distScoreJ = sqr(regs[i].ad2c.x) + sqr(regs[j].ad2c.y);
+			double regionScoreI = sqrt(regs.pixNum[i] / pixelNum);
+			double regionScoreJ = sqrt(regs.pixNum[j] / pixelNum);
+			double distScoreI = sqr(regs.ad2c[i].x) + sqr(regs.ad2c[i].y);
+			double distScoreJ = sqr(regs.ad2c[i].x) + sqr(regs.ad2c[j].y);
 
 			double scoreI = regSal[i] * exp(rcs.getRegionWeight() * regionScoreI - rcs.getDistanceWeight() * distScoreI);
 			double scoreJ = regSal[j] * exp(rcs.getRegionWeight() * regionScoreJ - rcs.getDistanceWeight() * distScoreJ);
@@ -0,0 +1,111 @@
+/*
+ * spanFill.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_RC_SPANFILL_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_RC_SPANFILL_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+/*
+ * Area, bounding box and centroid of a filled region, accumulated one row
+ * span at a time.
+ */
+struct SpanRegion {
+	int area;
+	Rect bounds;
+	double sumX, sumY;
+
+	SpanRegion() :
+			area(0), sumX(0), sumY(0) {
+	}
+
+	/*the pixels [x0, x1) of row y*/
+	void add(int y, int x0, int x1) {
+		int len = x1 - x0;
+		Rect span(x0, y, len, 1);
+		bounds = area == 0 ? span : (bounds | span);
+		area += len;
+		sumX += (x0 + x1 - 1) * 0.5 * len;
+		sumY += (double) y * len;
+	}
+
+	Point2d centroid() const {
+		return area > 0 ? Point2d(sumX / area, sumY / area) : Point2d();
+	}
+};
+
+/*
+ * Scanline flood fill. A whole row span is filled at once and only one
+ * seed per span of the rows above and below is pushed, on an explicit
+ * stack that is kept between calls, so a large uniform background costs
+ * a few pushes per row instead of one queue entry (or one recursion) per
+ * pixel.
+ *
+ * What is filled is up to the Policy:
+ *   bool inside(int y, int x) const; // the pixel belongs to the region and
+ *                                    // is not filled yet
+ *   void fill(int y, int x0, int x1); // fill [x0, x1) of row y, inside()
+ *                                     // must be false on it afterwards
+ */
+class SpanFill {
+public:
+	SpanFill(Size size, bool eightConnected = true) :
+			_size(size), _reach(eightConnected ? 1 : 0) {
+	}
+
+	/*fills the region of seed, empty if seed is not inside*/
+	template<class Policy>
+	SpanRegion fill(Policy &policy, Point seed) {
+		SpanRegion region;
+		if (!policy.inside(seed.y, seed.x))
+			return region;
+		_stack.clear();
+		_stack.push_back(seed);
+		while (!_stack.empty()) {
+			Point pt = _stack.back();
+			_stack.pop_back();
+			if (!policy.inside(pt.y, pt.x))
+				continue;
+			int x0 = pt.x, x1 = pt.x + 1;
+			while (x0 > 0 && policy.inside(pt.y, x0 - 1))
+				x0--;
+			while (x1 < _size.width && policy.inside(pt.y, x1))
+				x1++;
+			policy.fill(pt.y, x0, x1);
+			region.add(pt.y, x0, x1);
+
+			int lo = std::max(x0 - _reach, 0);
+			int hi = std::min(x1 + _reach, _size.width);
+			for (int y = pt.y - 1; y <= pt.y + 1; y += 2) {
+				if (y < 0 || y >= _size.height)
+					continue;
+				for (int x = lo; x < hi;) {
+					if (!policy.inside(y, x)) {
+						x++;
+						continue;
+					}
+					_stack.push_back(Point(x, y));
+					while (x < hi && policy.inside(y, x))
+						x++;
+				}
+			}
+		}
+		return region;
+	}
+
+private:
+	Size _size;
+	int _reach;
+	vector<Point> _stack;
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_RC_SPANFILL_H_ */
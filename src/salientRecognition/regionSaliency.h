@@ -0,0 +1,254 @@
+/*
+ * regionSaliency.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_REGIONSALIENCY_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_REGIONSALIENCY_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using namespace cv;
+using namespace std;
+
+/*
+ * Saliency by segment: the label image of the segmentation and one score
+ * per label (the mean saliency of its pixels). Each row of labels is also
+ * kept as runs of one label, so polygon queries walk runs instead of
+ * pixels, and the runs with the scores are all write() stores.
+ *
+ * This is an approximation of the SalientMap it is built from: the cut of
+ * RegionCut is not constant over a segment, so toMap() does not give the
+ * map back and a segment is salient or not as a whole.
+ *
+ * Like SalientMap, the labels are at the pyramid level the saliency was
+ * computed on, levels pyrDown below the image. Every query takes image
+ * coordinates.
+ */
+class RegionSaliency {
+public:
+	struct Run {
+		int x0, x1; // [x0, x1) of one row
+		int label;
+	};
+
+	RegionSaliency() :
+			levels(0) {
+	}
+
+	/*
+	 * labels1i: CV_32S in [0, regNum), sal1f: CV_32F of the same size
+	 */
+	RegionSaliency(const Mat& labels1i, int regNum, const Mat& sal1f,
+			int levels) :
+			labels(labels1i), levels(levels) {
+		vector<double> sum(regNum, 0);
+		rowStart.assign(labels.rows + 1, 0);
+		for (int y = 0; y < labels.rows; y++) {
+			const int* label = labels.ptr<int>(y);
+			const float* sal = sal1f.ptr<float>(y);
+			for (int x = 0; x < labels.cols; x++) {
+				sum[label[x]] += sal[x];
+				if (x == 0 || label[x] != label[x - 1]) {
+					Run run = { x, x + 1, label[x] };
+					runs.push_back(run);
+				} else {
+					runs.back().x1 = x + 1;
+				}
+			}
+			rowStart[y + 1] = runs.size();
+		}
+		scores.resize(regNum);
+		index();
+		for (int r = 0; r < regNum; r++)
+			scores[r] = pixNum[r] > 0 ? sum[r] / pixNum[r] : 0;
+	}
+
+	int regionNum() const {
+		return scores.size();
+	}
+
+	float score(int region) const {
+		return scores[region];
+	}
+
+	/*saliency at the point p of the image*/
+	float at(Point2f p) const {
+		Point q = toLabels(p);
+		return scores[labels.at<int>(q)];
+	}
+
+	bool isSalient(Point2f p, float thr = 0.5) const {
+		return at(p) > thr;
+	}
+
+	/*bounding box of a region in the image*/
+	Rect regionBounds(int region) const {
+		const Rect& b = bounds[region];
+		return Rect(b.x << levels, b.y << levels, b.width << levels,
+				b.height << levels);
+	}
+
+	/*
+	 * Regions scored above thr whose bounding box meets rect, both in the
+	 * image.
+	 */
+	vector<int> salientRegions(Rect rect, float thr = 0.5) const {
+		vector<int> res;
+		for (int r = 0; r < regionNum(); r++) {
+			if (scores[r] > thr && (regionBounds(r) & rect).area() > 0)
+				res.push_back(r);
+		}
+		return res;
+	}
+
+	/*
+	 * How much of the polygon is salient (precision) and how much of the
+	 * salient area is in the polygon (recall), with the segments scored
+	 * above thr as the salient area. Counted in label pixels whose center
+	 * is in the polygon: the rows of the polygon are cut into spans and
+	 * only meet the runs. An estimate, it is not coverage() of
+	 * integration.h, which counts the map at the image size.
+	 */
+	pair<float, float> coverage(const vector<Point2f>& polygon,
+			float thr = 0.5) const {
+		vector<Point2f> poly(polygon.size());
+		float ratio = 1.0f / (1 << levels);
+		float yMin = labels.rows, yMax = -1;
+		for (unsigned int i = 0; i < polygon.size(); i++) {
+			poly[i] = polygon[i] * ratio;
+			yMin = min(yMin, poly[i].y);
+			yMax = max(yMax, poly[i].y);
+		}
+		long long inside = 0, intersect = 0, salient = 0;
+		for (int r = 0; r < regionNum(); r++) {
+			if (scores[r] > thr)
+				salient += pixNum[r];
+		}
+		vector<float> xs;
+		int y0 = max(cvCeil(yMin - 0.5f), 0);
+		int y1 = min(cvFloor(yMax - 0.5f), labels.rows - 1);
+		for (int y = y0; y <= y1; y++) {
+			// crossings of the pixel centers row with the edges, even-odd
+			float cy = y + 0.5f;
+			xs.clear();
+			for (unsigned int i = 0, n = poly.size(); i < n; i++) {
+				const Point2f &a = poly[i], &b = poly[(i + 1) % n];
+				if ((a.y <= cy) != (b.y <= cy))
+					xs.push_back(a.x + (cy - a.y) * (b.x - a.x) / (b.y - a.y));
+			}
+			sort(xs.begin(), xs.end());
+			int k = rowStart[y];
+			for (unsigned int i = 0; i + 1 < xs.size(); i += 2) {
+				int x0 = max(cvCeil(xs[i] - 0.5f), 0);
+				int x1 = min(cvFloor(xs[i + 1] - 0.5f) + 1, labels.cols);
+				if (x0 >= x1)
+					continue;
+				inside += x1 - x0;
+				while (k < rowStart[y + 1] && runs[k].x1 <= x0)
+					k++;
+				for (int j = k; j < rowStart[y + 1] && runs[j].x0 < x1; j++) {
+					if (scores[runs[j].label] > thr)
+						intersect += min(runs[j].x1, x1) - max(runs[j].x0, x0);
+				}
+			}
+		}
+		float precision = inside > 0 ? intersect / (float) inside : 0;
+		float recall = salient > 0 ? intersect / (float) salient : 0;
+		return make_pair(precision, recall);
+	}
+
+	/*dense map at the labels resolution*/
+	Mat toMap() const {
+		Mat sal1f(labels.size(), CV_32F);
+		for (int y = 0; y < labels.rows; y++) {
+			float* sal = sal1f.ptr<float>(y);
+			for (int k = rowStart[y]; k < rowStart[y + 1]; k++) {
+				fill(sal + runs[k].x0, sal + runs[k].x1, scores[runs[k].label]);
+			}
+		}
+		return sal1f;
+	}
+
+	/*
+	 * The runs and the scores, a fraction of the size of the dense map.
+	 */
+	void write(FileStorage& fs) const {
+		vector<int> flat;
+		flat.reserve(runs.size() * 2);
+		for (unsigned int k = 0; k < runs.size(); k++) {
+			flat.push_back(runs[k].x1 - runs[k].x0);
+			flat.push_back(runs[k].label);
+		}
+		fs << "cols" << labels.cols << "rows" << labels.rows << "levels"
+				<< levels << "rowStart" << rowStart << "runs" << flat
+				<< "scores" << scores;
+	}
+
+	void read(const FileNode& node) {
+		int cols = (int) node["cols"], rows = (int) node["rows"];
+		levels = (int) node["levels"];
+		vector<int> flat;
+		node["rowStart"] >> rowStart;
+		node["runs"] >> flat;
+		node["scores"] >> scores;
+		labels.create(rows, cols, CV_32S);
+		runs.resize(flat.size() / 2);
+		for (int y = 0; y < rows; y++) {
+			int* label = labels.ptr<int>(y);
+			for (int k = rowStart[y], x = 0; k < rowStart[y + 1]; k++) {
+				Run run = { x, x + flat[2 * k], flat[2 * k + 1] };
+				runs[k] = run;
+				fill(label + run.x0, label + run.x1, run.label);
+				x = run.x1;
+			}
+		}
+		index();
+	}
+
+	Mat labels;
+	int levels;
+
+private:
+	/*pixel number and bounding box of every region, from the runs*/
+	void index() {
+		int regNum = scores.size();
+		pixNum.assign(regNum, 0);
+		vector<Point> tl(regNum, Point(labels.cols, labels.rows));
+		vector<Point> br(regNum, Point(-1, -1));
+		for (int y = 0; y < labels.rows; y++) {
+			for (int k = rowStart[y]; k < rowStart[y + 1]; k++) {
+				const Run& run = runs[k];
+				pixNum[run.label] += run.x1 - run.x0;
+				tl[run.label].x = min(tl[run.label].x, run.x0);
+				tl[run.label].y = min(tl[run.label].y, y);
+				br[run.label].x = max(br[run.label].x, run.x1);
+				br[run.label].y = y + 1;
+			}
+		}
+		bounds.assign(regNum, Rect());
+		for (int r = 0; r < regNum; r++) {
+			if (pixNum[r] > 0)
+				bounds[r] = Rect(tl[r], br[r]);
+		}
+	}
+
+	Point toLabels(Point2f p) const {
+		int x = cvFloor(p.x / (1 << levels)), y = cvFloor(p.y / (1 << levels));
+		return Point(min(max(x, 0), labels.cols - 1),
+				min(max(y, 0), labels.rows - 1));
+	}
+
+	vector<float> scores;
+	vector<int> pixNum;
+	vector<Rect> bounds; // in labels coordinates
+	vector<Run> runs;
+	vector<int> rowStart; // runs of row y: [rowStart[y], rowStart[y + 1])
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_REGIONSALIENCY_H_ */
@@ -0,0 +1,37 @@
+/*
+ * salientContext.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTCONTEXT_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTCONTEXT_H_
+
+#include <opencv2/opencv.hpp>
+#include <ctime>
+#include "segmentation/segment-graph.h"
+
+using namespace cv;
+
+/*
+ * Everything one saliency call modifies. GraphSegmentation, RegionCut and
+ * SalientRec only read their own members once constructed, so one context
+ * per thread is enough to run them concurrently.
+ */
+struct SalientContext {
+	/*replaces rand(): debug colors of the segmentation, seeds of RegionCut*/
+	RNG rng;
+	/*colored segmentation, only filled in debug mode*/
+	Mat realSeg;
+	/*start of the call, for the debug timing*/
+	clock_t tic;
+	/*graph and forest of the segmentation, reused by the next call*/
+	SegmentBuffers segment;
+
+	SalientContext(uint64 seed = 0x5a17e) :
+			rng(seed), tic(0) {
+	}
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTCONTEXT_H_ */
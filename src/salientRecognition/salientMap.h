@@ -0,0 +1,224 @@
+/*
+ * salientMap.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTMAP_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTMAP_H_
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+/*
+ * Saliency of an image, kept at the pyramid level it was computed on.
+ * The image is levels pyrDown above map: the point (x, y) of the image is
+ * (x, y) / 2^levels on map. Upsampling a 12MP image costs a 48MB float
+ * buffer, so consumers resample map to the size they work on or sample it
+ * with at(), and only ask for full() when they need the whole image.
+ * resized() and countNonZero() give what they would give on full(), from
+ * map. A Mat converts to a map of level 0.
+ */
+class SalientMap {
+public:
+	SalientMap() :
+			levels(0) {
+	}
+	SalientMap(const Mat& full) :
+			map(full), levels(0) {
+	}
+	SalientMap(const Mat& map, int levels) :
+			map(map), levels(levels) {
+	}
+
+	/*size of full()*/
+	Size size() const {
+		return Size(map.cols << levels, map.rows << levels);
+	}
+
+	bool empty() const {
+		return map.empty();
+	}
+
+	/*saliency at the point p of the image (nearest)*/
+	float at(Point2f p) const {
+		int x = std::min(std::max(cvFloor(p.x / (1 << levels)), 0), map.cols - 1);
+		int y = std::min(std::max(cvFloor(p.y / (1 << levels)), 0), map.rows - 1);
+		return map.at<float>(y, x);
+	}
+
+	/*
+	 * resize(full(), res, sz) (INTER_LINEAR) up to float rounding. The
+	 * pyrUps and the resize are linear and separable: each row of res is
+	 * a few weighted rows of map, then each column a few columns.
+	 */
+	Mat resized(Size sz) const {
+		Mat res;
+		if (levels == 0 || map.depth() != CV_32F) {
+			resize(full(), res, sz);
+			return res;
+		}
+		Mat tmp;
+		resample(map, sz.height, tmp);
+		transpose(tmp, tmp);
+		resample(tmp, sz.width, res);
+		transpose(res, res);
+		return res;
+	}
+
+	/*
+	 * cv::countNonZero(full()) of a map >= 0: a pixel of full() is not 0
+	 * when the pixels of map it is made of are not all 0. They are a
+	 * rectangle of map, so the count is taken on the integral of map != 0,
+	 * once per run of rows and of columns made of the same pixels.
+	 */
+	int countNonZero() const {
+		if (levels == 0)
+			return cv::countNonZero(map);
+		Mat nonZero = map != 0, sum;
+		integral(nonZero, sum, CV_32S);
+		vector<int> rowFirst, rowLast, rowCount, colFirst, colLast, colCount;
+		pyrUpSpans(map.rows, rowFirst, rowLast, rowCount);
+		pyrUpSpans(map.cols, colFirst, colLast, colCount);
+		int count = 0;
+		for (unsigned int r = 0; r < rowFirst.size(); r++) {
+			const int* top = sum.ptr<int>(rowFirst[r]);
+			const int* bottom = sum.ptr<int>(rowLast[r] + 1);
+			int cols = 0;
+			for (unsigned int c = 0; c < colFirst.size(); c++) {
+				int x0 = colFirst[c], x1 = colLast[c] + 1;
+				if (bottom[x1] - bottom[x0] - top[x1] + top[x0] > 0)
+					cols += colCount[c];
+			}
+			count += rowCount[r] * cols;
+		}
+		return count;
+	}
+
+	/*map upsampled to the image, same as Pyramid::reScale*/
+	Mat full() const {
+		Mat res = map, mid = map;
+		for (int i = 0; i < levels; ++i) {
+			pyrUp(mid, res, Size(mid.cols * 2, mid.rows * 2));
+			mid = res;
+		}
+		return res;
+	}
+
+	void release() {
+		map.release();
+		levels = 0;
+	}
+
+	Mat map;
+	int levels;
+
+private:
+	/*
+	 * The m rows of resize(full(), ...) along the side of n pixels of map:
+	 * row r gets the weights[r] of the rows from first[r] of map. The
+	 * linear resize takes 2 rows of full(), then every pyrUp is undone:
+	 * its row 2i is (i - 1, i, i + 1) * (1, 6, 1) / 8 and 2i + 1 is
+	 * (i, i + 1) * (4, 4) / 8, (i - 1, i) * (1, 7) / 8 and i on the last row.
+	 */
+	void resampleTaps(int n, int m, vector<int>& first,
+			vector<vector<float> >& weights) const {
+		int size = n << levels;
+		double scale = size / (double) m;
+		first.resize(m);
+		weights.resize(m);
+		vector<double> w, prev;
+		for (int r = 0; r < m; r++) {
+			float f = (float) ((r + 0.5) * scale - 0.5);
+			int lo = cvFloor(f);
+			f -= lo;
+			if (lo < 0)
+				f = 0, lo = 0;
+			if (lo >= size - 1)
+				f = 0, lo = size - 1;
+			w.assign(1, 1 - f);
+			if (f > 0)
+				w.push_back(f);
+			for (int k = levels - 1; k >= 0; k--) {
+				int last = (n << k) - 1;
+				int prevLo = max(lo / 2 - 1, 0);
+				int prevHi = min((lo + (int) w.size() - 1) / 2 + 1, last);
+				prev.assign(prevHi - prevLo + 1, 0);
+				for (unsigned int j = 0; j < w.size(); j++) {
+					int y = lo + j, i = y / 2 - prevLo;
+					if (last == 0) {
+						prev[i] += w[j];
+					} else if (y % 2 == 0 && y / 2 < last) {
+						prev[abs(y / 2 - 1) - prevLo] += w[j] / 8;
+						prev[i] += w[j] * 6 / 8;
+						prev[i + 1] += w[j] / 8;
+					} else if (y % 2 == 0) {
+						prev[i - 1] += w[j] / 8;
+						prev[i] += w[j] * 7 / 8;
+					} else if (y / 2 < last) {
+						prev[i] += w[j] / 2;
+						prev[i + 1] += w[j] / 2;
+					} else {
+						prev[i] += w[j];
+					}
+				}
+				w.swap(prev);
+				lo = prevLo;
+			}
+			first[r] = lo;
+			weights[r].assign(w.begin(), w.end());
+		}
+	}
+
+	/*the m rows of resize(full(), ...) from the rows of src, CV_32F*/
+	void resample(const Mat& src, int m, Mat& dst) const {
+		vector<int> first;
+		vector<vector<float> > weights;
+		resampleTaps(src.rows, m, first, weights);
+		int len = src.cols * src.channels();
+		dst = Mat::zeros(m, src.cols, src.type());
+		for (int r = 0; r < m; r++) {
+			float* d = dst.ptr<float>(r);
+			for (unsigned int k = 0; k < weights[r].size(); k++) {
+				const float* s = src.ptr<float>(first[r] + k);
+				float w = weights[r][k];
+				for (int x = 0; x < len; x++)
+					d[x] += w * s[x];
+			}
+		}
+	}
+
+	/*
+	 * The pixels of map that the n << levels rows of full() are made of,
+	 * along a side of n pixels, as runs of rows made of the same ones: run
+	 * j is count[j] rows made of the rows first[j] .. last[j] of map.
+	 */
+	void pyrUpSpans(int n, vector<int>& first, vector<int>& last,
+			vector<int>& count) const {
+		first.clear();
+		last.clear();
+		count.clear();
+		for (int y = 0; y < (n << levels); y++) {
+			int lo = y, hi = y;
+			for (int k = levels - 1; k >= 0; k--) {
+				int end = (n << k) - 1;
+				lo = lo % 2 == 0 ? max(lo / 2 - 1, 0) : lo / 2;
+				hi = min(hi / 2 + 1, end);
+			}
+			if (!first.empty() && first.back() == lo && last.back() == hi) {
+				count.back()++;
+			} else {
+				first.push_back(lo);
+				last.push_back(hi);
+				count.push_back(1);
+			}
+		}
+	}
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTMAP_H_ */
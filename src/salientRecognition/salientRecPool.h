@@ -0,0 +1,90 @@
+/*
+ * salientRecPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTRECPOOL_H_
+#define IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTRECPOOL_H_
+
+#include <vector>
+#include <mutex>
+#include "execute.h"
+
+using namespace std;
+
+/*
+ * Hands out SalientRec objects to concurrent callers. An object (and the
+ * context it owns) is used by one caller at a time and goes back to the pool
+ * afterwards, so the segmenters are built once per thread instead of once per
+ * image. A new object is created when none is idle, there is no upper bound:
+ * saliency has no expensive shared resource like the OCR engines.
+ */
+class SalientRecPool {
+public:
+	static SalientRecPool& instance() {
+		static SalientRecPool pool;
+		return pool;
+	}
+
+	SalientRec* acquire() {
+		{
+			lock_guard<mutex> lock(mtx);
+			if (!idle.empty()) {
+				SalientRec* src = idle.back();
+				idle.pop_back();
+				return src;
+			}
+		}
+		return new SalientRec();
+	}
+
+	void release(SalientRec* src) {
+		if (src == NULL)
+			return;
+		lock_guard<mutex> lock(mtx);
+		idle.push_back(src);
+	}
+
+	~SalientRecPool() {
+		for (unsigned int i = 0; i < idle.size(); i++) {
+			delete idle[i];
+		}
+	}
+
+private:
+	SalientRecPool() {
+	}
+	SalientRecPool(const SalientRecPool&);
+	SalientRecPool& operator=(const SalientRecPool&);
+
+	vector<SalientRec*> idle;
+	mutex mtx;
+};
+
+/*
+ * Holds one SalientRec of the pool for the lifetime of the object.
+ */
+class SalientRecLease {
+public:
+	SalientRecLease() :
+			src(SalientRecPool::instance().acquire()) {
+	}
+	~SalientRecLease() {
+		SalientRecPool::instance().release(src);
+	}
+	SalientRec& operator*() {
+		return *src;
+	}
+	SalientRec* operator->() {
+		return src;
+	}
+private:
+	SalientRecLease(const SalientRecLease&);
+	SalientRecLease& operator=(const SalientRecLease&);
+
+	SalientRec* src;
+};
+
+#endif /* IMAGE_PROCESS_SRC_SALIENTRECOGNITION_SALIENTRECPOOL_H_ */
@@ -1,60 +1,55 @@
 #ifndef DISJOINT_SET
 #define DISJOINT_SET
 
-// disjoint-set forests using union-by-rank and path compression (sort of).
+#include <algorithm>
+#include <vector>
 
-typedef struct {
-  int rank;
-  int parent;//parent idx
-  int size;
-} disjointElement;
+// disjoint-set forests using union-by-size and path halving.
+// The arrays are kept by reset(), so the same forest can be reused for
+// another image without allocating.
 
 class DisjointSet {
 public:
-  DisjointSet(int elements);
-  ~DisjointSet();
-  int find(int idx);  
+  DisjointSet(int elements = 0);
+  void reset(int elements);
+  int find(int idx);
   void join(int idxA, int idxB);
-  int size(int idx) const { return elts[idx].size; }
+  int size(int idx) const { return sizes[idx]; }
   int num_sets() const { return num; }
 
 private:
-  disjointElement *elts;
+  std::vector<int> parents;
+  std::vector<int> sizes;
   int num;
 };
 
 DisjointSet::DisjointSet(int elements) {
-  elts = new disjointElement[elements];
-  num = elements;
-  for (int i = 0; i < elements; i++) {
-    elts[i].rank = 0;
-    elts[i].size = 1;
-    elts[i].parent = i;
-  }
+  reset(elements);
 }
-  
-DisjointSet::~DisjointSet() {
-  delete [] elts;
+
+void DisjointSet::reset(int elements) {
+  parents.resize(elements);
+  sizes.assign(elements, 1);
+  num = elements;
+  for (int i = 0; i < elements; i++)
+    parents[i] = i;
 }
 
 int DisjointSet::find(int idx) {
-  int y = idx;
-  while (y != elts[y].parent)
-    y = elts[y].parent;
-  elts[idx].parent = y;
-  return y;
+  int *parent = &parents[0];
+  while (idx != parent[idx]) {
+    parent[idx] = parent[parent[idx]];
+    idx = parent[idx];
+  }
+  return idx;
 }
 
+// idxA and idxB are roots
 void DisjointSet::join(int idxA, int idxB) {
-  if (elts[idxA].rank > elts[idxB].rank) {
-    elts[idxB].parent = idxA;
-    elts[idxA].size += elts[idxB].size;
-  } else {
-    elts[idxA].parent = idxB;
-    elts[idxB].size += elts[idxA].size;
-    if (elts[idxA].rank == elts[idxB].rank)
-      elts[idxB].rank++;
-  }
+  if (sizes[idxA] < sizes[idxB])
+    std::swap(idxA, idxB);
+  parents[idxB] = idxA;
+  sizes[idxA] += sizes[idxB];
   num--;
 }
 
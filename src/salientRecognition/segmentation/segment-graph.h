@@ -3,9 +3,91 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 #include "disjoint-set.h"
 
 // threshold function
+#define THRESHOLD(size, c) (c/size)
 
+typedef struct {
+	float w;
+	int a, b;
+} edge;
+
+bool operator<(const edge &a, const edge &b) {
+	return a.w < b.w;
+}
+
+/*
+ * Scratch memory of one segmentation, kept between calls: an image of the
+ * same size does not allocate again.
+ *
+ * keys: the weight of each edge quantized to an int in [0, MAX_KEY], edges
+ * are sorted by it. The caller fills edges and keys.
+ */
+struct SegmentBuffers {
+	/*squared distance of two 8 bit Lab colors*/
+	static const int MAX_KEY = 3 * 255 * 255;
+
+	std::vector<edge> edges, sorted;
+	std::vector<int> keys, counts, labels;
+	std::vector<float> threshold;
+	DisjointSet forest;
+};
+
+/*
+ * Segment a graph
+ *
+ * Returns a disjoint-set forest representing the segmentation, it belongs
+ * to buf. buf.edges is left sorted by weight.
+ *
+ * num_vertices: number of vertices in graph.
+ * num_edges: number of edges in graph
+ * buf: edges and their keys, see SegmentBuffers.
+ * c: constant for treshold function.
+ */
+DisjointSet &segment_graph(int num_vertices, int num_edges,
+		SegmentBuffers &buf, float c) {
+	// counting sort of the edges by key, it is stable so edges of the same
+	// weight keep the order they were added in
+	int i;
+	buf.counts.assign(SegmentBuffers::MAX_KEY + 2, 0);
+	int *counts = &buf.counts[0];
+	const int *keys = &buf.keys[0];
+	for (i = 0; i < num_edges; i++)
+		counts[keys[i] + 1]++;
+	for (i = 1; i <= SegmentBuffers::MAX_KEY + 1; i++)
+		counts[i] += counts[i - 1];
+	if ((int) buf.sorted.size() < num_edges)
+		buf.sorted.resize(num_edges);
+	for (i = 0; i < num_edges; i++)
+		buf.sorted[counts[keys[i]]++] = buf.edges[i];
+	buf.edges.swap(buf.sorted);
+
+	// make a disjoint-set forest
+	DisjointSet &u = buf.forest;
+	u.reset(num_vertices);
+
+	// init thresholds
+	buf.threshold.assign(num_vertices, THRESHOLD(1, c));
+	float *threshold = &buf.threshold[0];
+
+	// for each edge, in non-decreasing weight order...
+	for (i = 0; i < num_edges; i++) {
+		const edge *pedge = &buf.edges[i];
+
+		// components conected by this edge
+		int a = u.find(pedge->a);
+		int b = u.find(pedge->b);
+		if (a != b) {
+			if ((pedge->w <= threshold[a]) && (pedge->w <= threshold[b])) {
+				u.join(a, b);
+				a = u.find(a);
+				threshold[a] = pedge->w + THRESHOLD(u.size(a), c);
+			}
+		}
+	}
+	return u;
+}
 
 #endif
@@ -6,79 +6,34 @@
 #include "image.h"
 #include "misc.h"
 #include "filter.h"
-#include "disjoint-set.h"
-
-#define THRESHOLD(size, c) (c/size)
-
-typedef struct {
-	float w;
-	int a, b;
-} edge;
-
-bool operator<(const edge &a, const edge &b) {
-	return a.w < b.w;
-}
-
-/*
- * Segment a graph
- *
- * Returns a disjoint-set forest representing the segmentation.
- *
- * num_vertices: number of vertices in graph.
- * num_edges: number of edges in graph
- * edges: array of edges.
- * c: constant for treshold function.
- */
-DisjointSet *segment_graph(int num_vertices, int num_edges, edge *edges,
-		float c) {
-	// sort edges by weight
-	std::sort(edges, edges + num_edges);
-
-	// make a disjoint-set forest
-	DisjointSet *u = new DisjointSet(num_vertices);
-
-	// init thresholds
-	float *threshold = new float[num_vertices];
-	int i;
-	for (i = 0; i < num_vertices; i++)
-		threshold[i] = THRESHOLD(1, c);
-
-	// for each edge, in non-decreasing weight order...
-	for (i = 0; i < num_edges; i++) {
-		edge *pedge = &edges[i];
-
-		// components conected by this edge
-		int a = u->find(pedge->a);
-		int b = u->find(pedge->b);
-		if (a != b) {
-			if ((pedge->w <= threshold[a]) && (pedge->w <= threshold[b])) {
-				u->join(a, b);
-				a = u->find(a);
-				threshold[a] = pedge->w + THRESHOLD(u->size(a), c);
-			}
-		}
-	}
-
-	// free up
-	delete[] threshold;
-	return u;
-}
+#include "segment-graph.h"
+#include "../salientContext.h"
+#include "../../util/stageTimer.h"
 
 class GraphSegmentation {
 public:
 	GraphSegmentation(float sigma = 1.2, float mergeThreshold = 200,
 			int min_size = 1000, bool debug = false);
+	/**
+	 * which is not thread-safe, the debug segmentation and the buffers are
+	 * kept in the object
+	 */
 	int segment_image(Mat &input, Mat &realSeg);
+	/**
+	 * reentrant: the debug segmentation and the buffers are in ctx
+	 */
+	int segment_image(Mat &input, Mat &realSeg, SalientContext &ctx) const;
 	Mat getRealSeg();
 private:
-	rgb random_rgb();
-	float diff(Vec3f &originPixel, Vec3f &comparedPixel);
+	rgb random_rgb(RNG &rng) const;
+	void add_edge(SegmentBuffers &buf, int &num, int a, int b,
+			const Vec3f &originPixel, const Vec3f &comparedPixel) const;
 
 	float _sigma; //variance of guassian filter
 	float _mergeThreshold;
 	int _minSize;
 	bool _debug;
-	Mat _realSeg;
+	SalientContext _context;
 };
 
 GraphSegmentation::GraphSegmentation(float sigma, float mergeThreshold,
@@ -89,25 +44,33 @@ GraphSegmentation::GraphSegmentation(float sigma, float mergeThreshold,
 }
 
 // random color
-rgb GraphSegmentation::random_rgb() {
+rgb GraphSegmentation::random_rgb(RNG &rng) const {
 	rgb c;
-	c.r = (uchar) rand();
-	c.g = (uchar) rand();
-	c.b = (uchar) rand();
+	c.r = (uchar) rng.uniform(0, 256);
+	c.g = (uchar) rng.uniform(0, 256);
+	c.b = (uchar) rng.uniform(0, 256);
 	return c;
 }
 
-// dissimilarity measure between pixels
+// edge between pixels a and b, its weight is the dissimilarity measure
 // sqrt((r1 - r2)^2 + (g1 - g2)^2 + (b1 - b2)^ 2)
-inline float GraphSegmentation::diff(Vec3f &originPixel, Vec3f &comparedPixel) {
+// and its key the squared distance: the smoothed 8 bit Lab values are
+// integers, so the key orders the edges exactly like the weight
+inline void GraphSegmentation::add_edge(SegmentBuffers &buf, int &num, int a,
+		int b, const Vec3f &originPixel, const Vec3f &comparedPixel) const {
 	float squared = square(originPixel[0] - comparedPixel[0])
 			+ square(originPixel[1] - comparedPixel[1])
 			+ square(originPixel[2] - comparedPixel[2]);
-	return sqrt(squared);
+	edge &e = buf.edges[num];
+	e.a = a;
+	e.b = b;
+	e.w = sqrt(squared);
+	buf.keys[num] = std::min(cvRound(squared), (int) SegmentBuffers::MAX_KEY);
+	num++;
 }
 
 Mat GraphSegmentation::getRealSeg() {
-	return _realSeg;
+	return _context.realSeg;
 }
 
 /*
@@ -122,6 +85,14 @@ Mat GraphSegmentation::getRealSeg() {
  * num_ccs: number of connected components in the segmentation.
  */
 int GraphSegmentation::segment_image(Mat &img3f, Mat &segments) {
+	_context.rng = RNG(theRNG()());
+	return segment_image(img3f, segments, _context);
+}
+
+int GraphSegmentation::segment_image(Mat &img3f, Mat &segments,
+		SalientContext &ctx) const {
+	static StageId stage("salient/segment");
+	ScopedTimer timer(stage);
 	Mat input;
 
 	cvtColor(img3f, input, CV_BGR2Lab);
@@ -131,99 +102,84 @@ int GraphSegmentation::segment_image(Mat &img3f, Mat &segments) {
 	int width = input.cols, height = input.rows;
 	int x, y, i;
 	// build graph
-	edge *edges = new edge[width * height * 4];
+	SegmentBuffers &buf = ctx.segment;
+	buf.edges.resize(width * height * 4);
+	buf.keys.resize(width * height * 4);
 	int num = 0;
 	for (y = 0; y < height; y++) {
-		Vec3f *row = smoothImage.ptr < Vec3f > (y);
+		const Vec3f *row = smoothImage.ptr < Vec3f > (y);
+		const Vec3f *down = smoothImage.ptr < Vec3f > (min(y + 1, height - 1));
+		const Vec3f *up = smoothImage.ptr < Vec3f > (max(y - 1, 0));
 		for (x = 0; x < width; x++) {
-			Vec3f currentPixel = row[x];
-			if (x < width - 1) {
-				edges[num].a = y * width + x;
-				edges[num].b = y * width + (x + 1);
-				edges[num].w = diff(currentPixel,
-						smoothImage.at < Vec3f > (y, x + 1));
-				num++;
-			}
-			if (y < height - 1) {
-				edges[num].a = y * width + x;
-				edges[num].b = (y + 1) * width + x;
-				edges[num].w = diff(currentPixel,
-						smoothImage.at < Vec3f > (y + 1, x));
-				num++;
-			}
-			if ((x < width - 1) && (y < height - 1)) {
-				edges[num].a = y * width + x;
-				edges[num].b = (y + 1) * width + (x + 1);
-				edges[num].w = diff(currentPixel,
-						smoothImage.at < Vec3f > (y + 1, x + 1));
-				num++;
-			}
-			if ((x < width - 1) && (y > 0)) {
-				edges[num].a = y * width + x;
-				edges[num].b = (y - 1) * width + (x + 1);
-				edges[num].w = diff(currentPixel,
-						smoothImage.at < Vec3f > (y - 1, x + 1));
-				num++;
-			}
+			int idx = y * width + x;
+			if (x < width - 1)
+				add_edge(buf, num, idx, idx + 1, row[x], row[x + 1]);
+			if (y < height - 1)
+				add_edge(buf, num, idx, idx + width, row[x], down[x]);
+			if ((x < width - 1) && (y < height - 1))
+				add_edge(buf, num, idx, idx + width + 1, row[x], down[x + 1]);
+			if ((x < width - 1) && (y > 0))
+				add_edge(buf, num, idx, idx - width + 1, row[x], up[x + 1]);
 		}
 	}
 	// segment
-	DisjointSet *edgeSet = segment_graph(width * height, num, edges,
+	DisjointSet &edgeSet = segment_graph(width * height, num, buf,
 			_mergeThreshold);
 
 	// post process small components
 	for (i = 0; i < num; i++) {
-		int a = edgeSet->find(edges[i].a);
-		int b = edgeSet->find(edges[i].b);
+		int a = edgeSet.find(buf.edges[i].a);
+		int b = edgeSet.find(buf.edges[i].b);
 		if ((a != b)
-				&& ((edgeSet->size(a) < _minSize)
-						|| (edgeSet->size(b) < _minSize)))
-			edgeSet->join(a, b);
+				&& ((edgeSet.size(a) < _minSize)
+						|| (edgeSet.size(b) < _minSize)))
+			edgeSet.join(a, b);
 	}
-	delete[] edges;
-	int num_ccs = edgeSet->num_sets();
+	int num_ccs = edgeSet.num_sets();
 	// pick random colors for each component
 	// for debug
+	ctx.realSeg.release();
 	if (_debug) {
 		image11<rgb> *output = new image11<rgb>(width, height);
 		rgb *colors = new rgb[width * height];
 		for (i = 0; i < width * height; i++)
-			colors[i] = random_rgb();
+			colors[i] = random_rgb(ctx.rng);
 		for (y = 0; y < height; y++) {
 			for (x = 0; x < width; x++) {
-				int comp = edgeSet->find(y * width + x);
+				int comp = edgeSet.find(y * width + x);
 				imRef(output, x, y) = colors[comp];
 			}
 		}
-		_realSeg.create(input.size(), CV_8UC3);
+		ctx.realSeg.create(input.size(), CV_8UC3);
 		for (int i = 0; i < output->h; ++i) {
 			for (int j = 0; j < output->w; ++j) {
-				_realSeg.at < cv::Vec3b > (i, j)[0] = output->data[i * output->w
+				ctx.realSeg.at < cv::Vec3b > (i, j)[0] = output->data[i * output->w
 						+ j].b;
-				_realSeg.at < cv::Vec3b > (i, j)[1] = output->data[i * output->w
+				ctx.realSeg.at < cv::Vec3b > (i, j)[1] = output->data[i * output->w
 						+ j].g;
-				_realSeg.at < cv::Vec3b > (i, j)[2] = output->data[i * output->w
+				ctx.realSeg.at < cv::Vec3b > (i, j)[2] = output->data[i * output->w
 						+ j].r;
 			}
 		}
 		delete[] colors;
+		delete output;
 	}
 
-	map<int, int> marker;
+	// number the components in the order they are met
+	buf.labels.assign(width * height, -1);
+	int *marker = &buf.labels[0];
 	segments.create(input.size(), 4);
 	int idxNum = 0;
 	for (int y = 0; y < height; ++y) {
 		int *imgIdx = segments.ptr<int>(y);
 		for (int x = 0; x < width; ++x) {
-			int comp = edgeSet->find(y * width + x);
-			if (marker.find(comp) == marker.end()) {
+			int comp = edgeSet.find(y * width + x);
+			if (marker[comp] < 0) {
 				marker[comp] = idxNum++;
 			}
-			int idx = marker[comp];
-			imgIdx[x] = idx;
+			imgIdx[x] = marker[comp];
 		}
 	}
-	delete edgeSet;
 	return num_ccs;
 }
 
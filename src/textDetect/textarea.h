@@ -148,6 +148,9 @@ int compareLineVert(const void * a, const void * b) {
 
 vector<Vec4i> block;
 int* gSortedLines;
+//the border drawn by myDrawLine, and the scale of the image to the original
+vector<Vec4i> gFinalLines(4);
+double gScale = 1.0;
 
 //calculate the slopes with a dictionary of edge points
 float slope(map<int, int>& dict, int type) {
@@ -639,10 +642,10 @@ void myDrawLine(int idx, int x, int y, float k, int cols, int rows) {
 
 	if (k == 0) {
 		//line(img,Point(0,y),Point(img.cols,y),CV_RGB(255,0,0),2);
-		finalines[idx][0] = 0;
-		finalines[idx][1] = y;
-		finalines[idx][2] = cols;
-		finalines[idx][3] = y;
+		gFinalLines[idx][0] = 0;
+		gFinalLines[idx][1] = y;
+		gFinalLines[idx][2] = cols;
+		gFinalLines[idx][3] = y;
 		return;
 	}
 	if (k < 99999) {
@@ -653,36 +656,36 @@ void myDrawLine(int idx, int x, int y, float k, int cols, int rows) {
 			int x2 = cols;
 			int y2 = k * x2 + b;
 			//line(img,Point(x1,y1),Point(x2,y2),CV_RGB(255,0,0),2);
-			finalines[idx][0] = x1;
-			finalines[idx][1] = y1;
-			finalines[idx][2] = x2;
-			finalines[idx][3] = y2;
+			gFinalLines[idx][0] = x1;
+			gFinalLines[idx][1] = y1;
+			gFinalLines[idx][2] = x2;
+			gFinalLines[idx][3] = y2;
 		} else {
 			int y1 = 0;
 			int x1 = (y1 - b) / k;
 			int y2 = rows;
 			int x2 = (y2 - b) / k;
 			//line(img,Point(x1,y1),Point(x2,y2),CV_RGB(255,0,0),2);
-			finalines[idx][0] = x1;
-			finalines[idx][1] = y1;
-			finalines[idx][2] = x2;
-			finalines[idx][3] = y2;
+			gFinalLines[idx][0] = x1;
+			gFinalLines[idx][1] = y1;
+			gFinalLines[idx][2] = x2;
+			gFinalLines[idx][3] = y2;
 		}
 	}
 	if (k >= 99999) {
 		//line(img,Point(x,0),Point(x,img.rows),CV_RGB(255,0,0),2);
-		finalines[idx][0] = x;
-		finalines[idx][1] = 0;
-		finalines[idx][2] = x;
-		finalines[idx][3] = rows;
+		gFinalLines[idx][0] = x;
+		gFinalLines[idx][1] = 0;
+		gFinalLines[idx][2] = x;
+		gFinalLines[idx][3] = rows;
 	}
 }
 
 void textBorder(Mat& orig, Mat& src, vector<Mat>& rst) {
 	std::vector<cv::Point2f> corners;
-	for (int i = 0; i < finalines.size(); i++) {
-		for (int j = i + 1; j < finalines.size(); j++) {
-			cv::Point2f pt = computeLineIntersect(finalines[i], finalines[j]);
+	for (int i = 0; i < gFinalLines.size(); i++) {
+		for (int j = i + 1; j < gFinalLines.size(); j++) {
+			cv::Point2f pt = computeLineIntersect(gFinalLines[i], gFinalLines[j]);
 
 			if (pt.x < 0 && pt.x > -10)
 				pt.x = 0;
@@ -711,8 +714,7 @@ void textBorder(Mat& orig, Mat& src, vector<Mat>& rst) {
 		return;
 	}
 
-	center.x = 0.0;
-	center.y = 0.0;
+	cv::Point2f center(0, 0);
 	// Get mass center
 	for (int i = 0; i < corners.size(); i++)
 		center += corners[i];
@@ -730,7 +732,7 @@ void textBorder(Mat& orig, Mat& src, vector<Mat>& rst) {
 	}
 
 	Mat turned;
-	turnImage(orig, turned, corners, scale);
+	turnImage(orig, turned, corners, gScale);
 	rst.push_back(turned);
 }
 
@@ -1086,8 +1088,7 @@ int textDetect(Mat& src, vector<Mat>& textPieces, bool border) {
 	Mat tsrc;
 	if (src.empty())
 		return -1;
-	scale = 1.0;
-	myNormalSize(src, tsrc, CV_32S);
+	gScale = myNormalSize(src, tsrc, CV_32S);
 	vector<Mat> rst;
 	int ret = detectText2(src, tsrc, rst, border);
 
@@ -0,0 +1,145 @@
+/*
+ * artifactWriter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_UTIL_ARTIFACTWRITER_H_
+#define IMAGE_PROCESS_SRC_UTIL_ARTIFACTWRITER_H_
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include "boundedQueue.h"
+
+using namespace std;
+using namespace cv;
+
+/*
+ * Writes the debug images (salient, border, text pieces...) on a background
+ * thread, so the encoding is off the processing path.
+ * Policy:
+ *   none     no images are written
+ *   sample:N the images of 1 in N processed images are written
+ *   all      every image is written (default)
+ */
+class ArtifactWriter {
+public:
+	enum Policy {
+		NONE, SAMPLE, ALL
+	};
+
+	static ArtifactWriter& instance() {
+		static ArtifactWriter writer;
+		return writer;
+	}
+
+	/*
+	 * spec is "none", "all" or "sample:N". Returns false on a bad spec.
+	 */
+	bool setPolicy(const string& spec) {
+		if (spec == "none") {
+			policy = NONE;
+		} else if (spec == "all") {
+			policy = ALL;
+		} else if (spec.compare(0, 7, "sample:") == 0
+				&& atoi(spec.c_str() + 7) > 0) {
+			policy = SAMPLE;
+			sampleRate = atoi(spec.c_str() + 7);
+		} else {
+			cerr << "Unknown artifact policy: " << spec
+					<< " (none, sample:N or all)" << endl;
+			return false;
+		}
+		return true;
+	}
+
+	/*
+	 * Called once per processed image, tells whether its artifacts are written.
+	 */
+	bool sampleImage() {
+		switch (policy) {
+		case NONE:
+			return false;
+		case SAMPLE:
+			return imageCount++ % sampleRate == 0;
+		default:
+			return true;
+		}
+	}
+
+	/*
+	 * Queues img to be written to path; blocks if the queue is full.
+	 * img must not be modified afterwards (clone it if it is).
+	 */
+	void write(const string& path, const Mat& img) {
+		startOnce();
+		{
+			lock_guard<mutex> lock(pendingMtx);
+			pending++;
+		}
+		queue.push(make_pair(path, img));
+	}
+
+	/*
+	 * Waits until every queued image is written.
+	 */
+	void flush() {
+		unique_lock<mutex> lock(pendingMtx);
+		while (pending > 0) {
+			drained.wait(lock);
+		}
+	}
+
+	~ArtifactWriter() {
+		queue.close();
+		if (worker.joinable())
+			worker.join();
+	}
+
+private:
+	ArtifactWriter() :
+			policy(ALL), sampleRate(1), imageCount(0), pending(0), queue(16) {
+	}
+	ArtifactWriter(const ArtifactWriter&);
+	ArtifactWriter& operator=(const ArtifactWriter&);
+
+	void startOnce() {
+		lock_guard<mutex> lock(startMtx);
+		if (!worker.joinable())
+			worker = thread(&ArtifactWriter::run, this);
+	}
+
+	void run() {
+		pair<string, Mat> item;
+		while (queue.pop(item)) {
+			try {
+				if (!imwrite(item.first, item.second))
+					cerr << "Can't write " << item.first << endl;
+			} catch (cv::Exception& e) {
+				cerr << "Can't write " << item.first << ": " << e.what()
+						<< endl;
+			}
+			item.second.release();
+			lock_guard<mutex> lock(pendingMtx);
+			if (--pending == 0)
+				drained.notify_all();
+		}
+	}
+
+	Policy policy;
+	int sampleRate;
+	atomic<unsigned int> imageCount;
+	int pending;
+	mutex pendingMtx;
+	condition_variable drained;
+	mutex startMtx;
+	thread worker;
+	BoundedQueue<pair<string, Mat> > queue;
+};
+
+#endif /* IMAGE_PROCESS_SRC_UTIL_ARTIFACTWRITER_H_ */
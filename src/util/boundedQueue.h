@@ -0,0 +1,101 @@
+/*
+ * boundedQueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_UTIL_BOUNDEDQUEUE_H_
+#define IMAGE_PROCESS_SRC_UTIL_BOUNDEDQUEUE_H_
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+/*
+ * Blocking FIFO with a fixed capacity, for handing work between threads.
+ * push() waits while the queue is full, pop() waits while it is empty.
+ * After close() no more items are accepted, and pop() returns false once
+ * the remaining items are taken.
+ */
+template<class T>
+class BoundedQueue {
+public:
+	BoundedQueue(size_t capacity) :
+			_capacity(capacity < 1 ? 1 : capacity), _closed(false), _maxDepth(
+					0) {
+	}
+
+	/*
+	 * Returns false (and drops item) if the queue is closed.
+	 */
+	bool push(const T& item) {
+		unique_lock<mutex> lock(mtx);
+		while (items.size() >= _capacity && !_closed) {
+			notFull.wait(lock);
+		}
+		if (_closed)
+			return false;
+		items.push_back(item);
+		if (items.size() > _maxDepth)
+			_maxDepth = items.size();
+		notEmpty.notify_one();
+		return true;
+	}
+
+	/*
+	 * Returns false if the queue is closed and empty.
+	 */
+	bool pop(T& item) {
+		unique_lock<mutex> lock(mtx);
+		while (items.empty() && !_closed) {
+			notEmpty.wait(lock);
+		}
+		if (items.empty())
+			return false;
+		item = items.front();
+		items.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	void close() {
+		lock_guard<mutex> lock(mtx);
+		_closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+	size_t size() {
+		lock_guard<mutex> lock(mtx);
+		return items.size();
+	}
+
+	/*
+	 * The largest number of items that were queued at the same time.
+	 */
+	size_t maxDepth() {
+		lock_guard<mutex> lock(mtx);
+		return _maxDepth;
+	}
+
+	size_t capacity() const {
+		return _capacity;
+	}
+
+private:
+	BoundedQueue(const BoundedQueue&);
+	BoundedQueue& operator=(const BoundedQueue&);
+
+	deque<T> items;
+	size_t _capacity;
+	bool _closed;
+	size_t _maxDepth;
+	mutex mtx;
+	condition_variable notEmpty;
+	condition_variable notFull;
+};
+
+#endif /* IMAGE_PROCESS_SRC_UTIL_BOUNDEDQUEUE_H_ */
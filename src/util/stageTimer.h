@@ -0,0 +1,304 @@
+/*
+ * stageTimer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_UTIL_STAGETIMER_H_
+#define IMAGE_PROCESS_SRC_UTIL_STAGETIMER_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+/*
+ * Latency histograms per processing stage.
+ *
+ * Usage, at the top of the code to measure:
+ *   static StageId stage("salient/quantize");
+ *   ScopedTimer timer(stage);
+ *
+ * Every thread records into its own histograms (relaxed atomics, no lock),
+ * StageStats merges them when the JSON is dumped. Durations are kept in
+ * microseconds in log-linear buckets: exact below 16us, then 8 buckets per
+ * power of two (at most 12.5% error on the percentiles).
+ */
+class StageStats {
+public:
+	enum {
+		MAX_STAGES = 64,
+		LINEAR_BUCKETS = 16,
+		SUB_BUCKETS = 8,
+		BUCKETS = LINEAR_BUCKETS + 40 * SUB_BUCKETS
+	};
+
+	struct Histogram {
+		atomic<unsigned long long> buckets[BUCKETS];
+		atomic<unsigned long long> count;
+		atomic<unsigned long long> sum;
+		atomic<unsigned long long> max;
+
+		Histogram() :
+				count(0), sum(0), max(0) {
+			for (int i = 0; i < BUCKETS; i++)
+				buckets[i] = 0;
+		}
+
+		/*
+		 * Only called by the owning thread, so load+store is enough for max.
+		 */
+		void record(unsigned long long us) {
+			buckets[bucketOf(us)].fetch_add(1, memory_order_relaxed);
+			count.fetch_add(1, memory_order_relaxed);
+			sum.fetch_add(us, memory_order_relaxed);
+			if (us > max.load(memory_order_relaxed))
+				max.store(us, memory_order_relaxed);
+		}
+	};
+
+	static StageStats& instance() {
+		static StageStats stats;
+		return stats;
+	}
+
+	/*
+	 * Returns the id of the stage called name, registering it if needed.
+	 */
+	int registerStage(const string& name) {
+		lock_guard<mutex> lock(mtx);
+		for (unsigned int i = 0; i < names.size(); i++) {
+			if (names[i] == name)
+				return i;
+		}
+		if ((int) names.size() >= MAX_STAGES) {
+			cerr << "Too many stages, " << name << " is not timed" << endl;
+			return -1;
+		}
+		names.push_back(name);
+		return names.size() - 1;
+	}
+
+	void record(int stage, unsigned long long us) {
+		if (stage < 0)
+			return;
+		ThreadHistograms* local = threadHistograms();
+		Histogram* h = local->stages[stage].load(memory_order_acquire);
+		if (h == NULL) {
+			h = new Histogram();
+			local->stages[stage].store(h, memory_order_release);
+		}
+		h->record(us);
+	}
+
+	struct Summary {
+		string name;
+		unsigned long long count;
+		double meanMs, p50Ms, p95Ms, p99Ms, maxMs;
+	};
+
+	/*
+	 * The merged statistics of every stage that recorded something, in the
+	 * order the stages were registered.
+	 */
+	vector<Summary> summaries() {
+		lock_guard<mutex> lock(mtx);
+		vector<Summary> result;
+		for (unsigned int s = 0; s < names.size(); s++) {
+			vector<unsigned long long> merged(BUCKETS, 0);
+			unsigned long long count = 0, sum = 0, max = 0;
+			for (unsigned int t = 0; t < threads.size(); t++) {
+				Histogram* h = threads[t]->stages[s].load(
+						memory_order_acquire);
+				if (h == NULL)
+					continue;
+				for (int b = 0; b < BUCKETS; b++)
+					merged[b] += h->buckets[b].load(memory_order_relaxed);
+				count += h->count.load(memory_order_relaxed);
+				sum += h->sum.load(memory_order_relaxed);
+				if (h->max.load(memory_order_relaxed) > max)
+					max = h->max.load(memory_order_relaxed);
+			}
+			if (count == 0)
+				continue;
+			Summary summary;
+			summary.name = names[s];
+			summary.count = count;
+			summary.meanMs = sum / 1000.0 / count;
+			summary.p50Ms = percentile(merged, 0.50) / 1000.0;
+			summary.p95Ms = percentile(merged, 0.95) / 1000.0;
+			summary.p99Ms = percentile(merged, 0.99) / 1000.0;
+			summary.maxMs = max / 1000.0;
+			result.push_back(summary);
+		}
+		return result;
+	}
+
+	/*
+	 * {"stages":[{"name":..,"count":..,"mean_ms":..,"p50_ms":..,"p95_ms":..,
+	 * "p99_ms":..,"max_ms":..},...]}
+	 */
+	string toJson() {
+		vector<Summary> stats = summaries();
+		ostringstream os;
+		os << "{\"stages\":[";
+		for (unsigned int i = 0; i < stats.size(); i++) {
+			os << (i == 0 ? "" : ",") << "{\"name\":\"" << stats[i].name
+					<< "\",\"count\":" << stats[i].count << ",\"mean_ms\":"
+					<< stats[i].meanMs << ",\"p50_ms\":" << stats[i].p50Ms
+					<< ",\"p95_ms\":" << stats[i].p95Ms << ",\"p99_ms\":"
+					<< stats[i].p99Ms << ",\"max_ms\":" << stats[i].maxMs
+					<< "}";
+		}
+		os << "]}";
+		return os.str();
+	}
+
+	/*
+	 * Same as toJson, as a human readable table.
+	 */
+	void printTable(ostream& os) {
+		vector<Summary> stats = summaries();
+		char line[256];
+		snprintf(line, sizeof(line), "%-24s %8s %10s %10s %10s %10s %10s\n",
+				"stage", "count", "mean(ms)", "p50", "p95", "p99", "max");
+		os << line;
+		for (unsigned int i = 0; i < stats.size(); i++) {
+			snprintf(line, sizeof(line),
+					"%-24s %8llu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+					stats[i].name.c_str(), stats[i].count, stats[i].meanMs,
+					stats[i].p50Ms, stats[i].p95Ms, stats[i].p99Ms,
+					stats[i].maxMs);
+			os << line;
+		}
+	}
+
+	bool dumpJson(const string& path) {
+		ofstream out(path.c_str());
+		if (!out) {
+			cerr << "Can't write stage timings to " << path << endl;
+			return false;
+		}
+		out << toJson() << endl;
+		return true;
+	}
+
+	static int bucketOf(unsigned long long us) {
+		if (us < LINEAR_BUCKETS)
+			return us;
+		int e = 63 - __builtin_clzll(us); // us >= 2^e, e >= 4
+		int b = LINEAR_BUCKETS + (e - 4) * SUB_BUCKETS
+				+ ((us >> (e - 3)) & (SUB_BUCKETS - 1));
+		return b < BUCKETS ? b : BUCKETS - 1;
+	}
+
+	/*
+	 * Middle of the microsecond range covered by bucket b.
+	 */
+	static double bucketValue(int b) {
+		if (b < LINEAR_BUCKETS)
+			return b;
+		int e = (b - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+		int sub = (b - LINEAR_BUCKETS) % SUB_BUCKETS;
+		double width = (double) (1ULL << (e - 3));
+		return (double) (1ULL << e) + (sub + 0.5) * width;
+	}
+
+private:
+	struct ThreadHistograms {
+		atomic<Histogram*> stages[MAX_STAGES];
+		ThreadHistograms() {
+			for (int i = 0; i < MAX_STAGES; i++)
+				stages[i] = NULL;
+		}
+	};
+
+	StageStats() {
+	}
+	StageStats(const StageStats&);
+	StageStats& operator=(const StageStats&);
+
+	/*
+	 * The histograms outlive their thread, so a finished worker still shows
+	 * up in the dump.
+	 */
+	ThreadHistograms* threadHistograms() {
+		static thread_local ThreadHistograms* local = NULL;
+		if (local == NULL) {
+			local = new ThreadHistograms();
+			lock_guard<mutex> lock(mtx);
+			threads.push_back(local);
+		}
+		return local;
+	}
+
+	static double percentile(const vector<unsigned long long>& buckets,
+			double q) {
+		unsigned long long total = 0;
+		for (unsigned int b = 0; b < buckets.size(); b++)
+			total += buckets[b];
+		unsigned long long rank = (unsigned long long) (q * total);
+		if (rank >= total)
+			rank = total - 1;
+		unsigned long long seen = 0;
+		for (unsigned int b = 0; b < buckets.size(); b++) {
+			seen += buckets[b];
+			if (seen > rank)
+				return bucketValue(b);
+		}
+		return 0;
+	}
+
+	mutex mtx;
+	vector<string> names;
+	vector<ThreadHistograms*> threads;
+};
+
+/*
+ * A stage name resolved once to its id, keep it in a static.
+ */
+class StageId {
+public:
+	StageId(const string& name) :
+			id(StageStats::instance().registerStage(name)) {
+	}
+	const int id;
+};
+
+/*
+ * Records the time between construction and destruction for stage.
+ */
+class ScopedTimer {
+public:
+	ScopedTimer(const StageId& stage) :
+			stage(stage.id), start(chrono::steady_clock::now()) {
+	}
+	~ScopedTimer() {
+		stop();
+	}
+	/*
+	 * Records now instead of at the end of the scope.
+	 */
+	void stop() {
+		if (stage < 0)
+			return;
+		chrono::steady_clock::duration d = chrono::steady_clock::now()
+				- start;
+		StageStats::instance().record(stage,
+				chrono::duration_cast<chrono::microseconds>(d).count());
+		stage = -1;
+	}
+private:
+	int stage;
+	chrono::steady_clock::time_point start;
+};
+
+#endif /* IMAGE_PROCESS_SRC_UTIL_STAGETIMER_H_ */
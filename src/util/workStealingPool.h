@@ -0,0 +1,101 @@
+/*
+ * workStealingPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_UTIL_WORKSTEALINGPOOL_H_
+#define IMAGE_PROCESS_SRC_UTIL_WORKSTEALINGPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+
+using namespace std;
+
+/*
+ * A batch thread pool: tasks are submitted before run(), spread round-robin
+ * over one deque per worker. A worker takes its own tasks from the back and,
+ * once it runs dry, steals from the front of the other workers' deques, so
+ * a few slow images don't leave the rest of the threads idle.
+ * A task receives the index of the worker running it, which can be used to
+ * pick per-worker state (e.g. a SalientRec).
+ */
+class WorkStealingPool {
+public:
+	typedef function<void(int)> Task;
+
+	WorkStealingPool(int threads) :
+			queues(threads < 1 ? 1 : threads), next(0) {
+	}
+
+	int size() const {
+		return (int) queues.size();
+	}
+
+	void submit(const Task& task) {
+		WorkerQueue& q = queues[next];
+		next = (next + 1) % queues.size();
+		lock_guard<mutex> lock(q.mtx);
+		q.tasks.push_back(task);
+	}
+
+	/*
+	 * Runs all submitted tasks and returns when they are finished.
+	 */
+	void run() {
+		vector<thread> workers;
+		for (int i = 1; i < size(); i++) {
+			workers.push_back(thread(&WorkStealingPool::work, this, i));
+		}
+		work(0);
+		for (unsigned int i = 0; i < workers.size(); i++) {
+			workers[i].join();
+		}
+	}
+
+private:
+	struct WorkerQueue {
+		mutex mtx;
+		deque<Task> tasks;
+	};
+
+	bool popOwn(int id, Task& task) {
+		WorkerQueue& q = queues[id];
+		lock_guard<mutex> lock(q.mtx);
+		if (q.tasks.empty())
+			return false;
+		task = q.tasks.back();
+		q.tasks.pop_back();
+		return true;
+	}
+
+	bool steal(int id, Task& task) {
+		for (int k = 1; k < size(); k++) {
+			WorkerQueue& q = queues[(id + k) % size()];
+			lock_guard<mutex> lock(q.mtx);
+			if (!q.tasks.empty()) {
+				task = q.tasks.front();
+				q.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void work(int id) {
+		Task task;
+		/*no task is submitted while running, so empty everywhere means done*/
+		while (popOwn(id, task) || steal(id, task)) {
+			task(id);
+		}
+	}
+
+	vector<WorkerQueue> queues;
+	unsigned int next;
+};
+
+#endif /* IMAGE_PROCESS_SRC_UTIL_WORKSTEALINGPOOL_H_ */
@@ -0,0 +1,210 @@
+/*
+ * pipeline.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_WORKFLOW_PIPELINE_H_
+#define IMAGE_PROCESS_SRC_WORKFLOW_PIPELINE_H_
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include "../util/boundedQueue.h"
+#include "../salientRecognition/salientMap.h"
+
+using namespace std;
+using namespace cv;
+
+/*
+ * One image travelling through the pipeline. Each stage fills in its part.
+ */
+struct ImageJob {
+	string input; // full path of the image
+	string name; // file name inside the input directory
+	Mat img;
+	SalientMap outputSRC;
+	Mat outputBD;
+	int res;
+	vector<Mat> textPieces;
+	bool artifacts; // whether the debug images of this image are written
+	bool failed;
+
+	ImageJob(const string& input, const string& name) :
+			input(input), name(name), res(-1), artifacts(false), failed(
+					false) {
+	}
+};
+
+/*
+ * Runs images through a chain of stages. Every stage has its own threads
+ * and an input queue of bounded size, so a slow stage holds back the ones
+ * before it instead of piling up decoded images in memory, while stages
+ * of different images overlap.
+ * A stage function gets the job and the index of the stage thread running
+ * it (to pick per-thread state). If it throws, the job is marked failed
+ * and skipped by the following stages.
+ */
+class Pipeline {
+public:
+	typedef function<void(ImageJob&, int)> StageFunc;
+
+	Pipeline(int queueCapacity) :
+			queueCapacity(queueCapacity), monitorStop(false) {
+	}
+
+	~Pipeline() {
+		for (unsigned int i = 0; i < stages.size(); i++) {
+			delete stages[i]->input;
+			delete stages[i];
+		}
+	}
+
+	void addStage(const string& name, int threads, StageFunc func) {
+		Stage* stage = new Stage();
+		stage->name = name;
+		stage->threads = threads < 1 ? 1 : threads;
+		stage->func = func;
+		stage->input = new BoundedQueue<ImageJob*>(queueCapacity);
+		stages.push_back(stage);
+	}
+
+	/*
+	 * Starts the stage threads. If reportMs > 0 the queue depths are
+	 * printed every reportMs milliseconds.
+	 */
+	void start(int reportMs = 0) {
+		for (unsigned int s = 0; s < stages.size(); s++) {
+			stages[s]->running = stages[s]->threads;
+			for (int t = 0; t < stages[s]->threads; t++) {
+				threads.push_back(thread(&Pipeline::runStage, this, s, t));
+			}
+		}
+		if (reportMs > 0) {
+			monitor = thread(&Pipeline::runMonitor, this, reportMs);
+		}
+	}
+
+	/*
+	 * Blocks while the first queue is full. The pipeline owns job afterwards.
+	 */
+	void push(ImageJob* job) {
+		if (!stages[0]->input->push(job))
+			delete job;
+	}
+
+	/*
+	 * No more jobs; waits until every pushed job left the last stage.
+	 */
+	void finish() {
+		stages[0]->input->close();
+		for (unsigned int i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+		threads.clear();
+		if (monitor.joinable()) {
+			{
+				lock_guard<mutex> lock(monitorMtx);
+				monitorStop = true;
+			}
+			monitorCond.notify_all();
+			monitor.join();
+		}
+	}
+
+	/*
+	 * Current number of jobs waiting in front of each stage.
+	 */
+	vector<pair<string, int> > queueDepths() {
+		vector<pair<string, int> > depths;
+		for (unsigned int i = 0; i < stages.size(); i++) {
+			depths.push_back(
+					make_pair(stages[i]->name, (int) stages[i]->input->size()));
+		}
+		return depths;
+	}
+
+	void printQueueDepths(ostream& os) {
+		vector<pair<string, int> > depths = queueDepths();
+		os << "queue depth:";
+		for (unsigned int i = 0; i < depths.size(); i++) {
+			os << " " << depths[i].first << "=" << depths[i].second << "/"
+					<< queueCapacity;
+		}
+		os << endl;
+	}
+
+	/*
+	 * Deepest each queue has been, a full queue in front of a stage means
+	 * that stage is the bottleneck.
+	 */
+	void printMaxQueueDepths(ostream& os) {
+		os << "max queue depth:";
+		for (unsigned int i = 0; i < stages.size(); i++) {
+			os << " " << stages[i]->name << "="
+					<< stages[i]->input->maxDepth() << "/" << queueCapacity;
+		}
+		os << endl;
+	}
+
+private:
+	struct Stage {
+		string name;
+		int threads;
+		StageFunc func;
+		BoundedQueue<ImageJob*>* input;
+		atomic<int> running;
+	};
+
+	void runStage(unsigned int s, int worker) {
+		Stage* stage = stages[s];
+		ImageJob* job;
+		while (stage->input->pop(job)) {
+			if (!job->failed) {
+				try {
+					stage->func(*job, worker);
+				} catch (std::exception& e) {
+					cerr << stage->name << " failed on " << job->input << ": "
+							<< e.what() << endl;
+					job->failed = true;
+				}
+			}
+			if (s + 1 < stages.size())
+				stages[s + 1]->input->push(job);
+			else
+				delete job;
+		}
+		if (--stage->running == 0 && s + 1 < stages.size()) {
+			stages[s + 1]->input->close();
+		}
+	}
+
+	void runMonitor(int reportMs) {
+		unique_lock<mutex> lock(monitorMtx);
+		while (!monitorStop) {
+			if (monitorCond.wait_for(lock, chrono::milliseconds(reportMs))
+					== cv_status::timeout && !monitorStop) {
+				printQueueDepths(cout);
+			}
+		}
+	}
+
+	Pipeline(const Pipeline&);
+	Pipeline& operator=(const Pipeline&);
+
+	int queueCapacity;
+	vector<Stage*> stages;
+	vector<thread> threads;
+	thread monitor;
+	mutex monitorMtx;
+	condition_variable monitorCond;
+	bool monitorStop;
+};
+
+#endif /* IMAGE_PROCESS_SRC_WORKFLOW_PIPELINE_H_ */
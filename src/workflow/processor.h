@@ -11,6 +11,7 @@
 #include "../preprocessing/utils/OCRUtil.h"
 #include "../util/configUtil.h"
 #include "../salientRecognition/execute.h"
+#include "../salientRecognition/salientRecPool.h"
 #include "../preprocessing/utils/FileUtil.h"
 #include "../borderPosition/border.h"
 #include "../textDetect/textarea.h"
@@ -19,6 +20,11 @@
 #include "../preprocessing/GaussianSPDenoise/denoise.h"
 #include "../preprocessing/utils/TimeUtil.h"
 #include "../preprocessing/cca/CCA.h"
+#include "../util/workStealingPool.h"
+#include "pipeline.h"
+#include "../util/artifactWriter.h"
+#include "../util/stageTimer.h"
+#include <atomic>
 
 using namespace std;
 using namespace cv;
@@ -29,6 +35,13 @@ using namespace cv;
  * -i Input file or input directory (depends on mode).
  * -o OCR output directory.
  * -c Configuration file path, (method = directory). see sn.conf as an example.
+ * -j Number of worker threads in directory mode (default 1).
+ * -t Number of OCR threads for the text pieces of one image (default 1).
+ * -p Pipeline mode for directories, every step runs on its own threads (-j per heavy step).
+ * -a Debug image policy: none, sample:N (1 in N images) or all (default).
+ * -T Write the stage timings (JSON, see stageTimer.h) to the given file at exit, not with -S.
+ * -S Server mode, serve requests on the given Unix socket path with -j workers (see server.h).
+ * -C Client mode, send -i (-s or -d) to the server at the given Unix socket path.
  * ex. ./image_process -s -i "test/workflow/input/ad1.jpg" -o "test/workflow/ocr" -c sn.conf
  */
 
@@ -43,14 +56,17 @@ public:
 	const static string DESKEW;
 	const static string CCA;
 
+	/*
+	 * Stage timings, see stageTimer.h.
+	 */
+	const static StageId IMAGE_STAGE;
+	const static StageId DECODE_STAGE;
+	const static StageId SALIENT_STAGE;
+	const static StageId BORDER_STAGE;
+	const static StageId TEXT_STAGE;
+	const static StageId PREPROCESS_STAGE;
+
 	static string lang;
-//	static int time01;
-//	static int time02;
-//	static int time1;
-//	static int time2;
-//	static int time3;
-//	static int time4;
-//	static int nopic;
 
 	static void usage() {
 		cout << "Please add parameters:" << endl;
@@ -61,6 +77,26 @@ public:
 		cout
 				<< " -c Configuration file path, (method = directory). see sn.conf as an example."
 				<< endl;
+		cout << " -j Number of worker threads in directory mode (default 1)."
+				<< endl;
+		cout
+				<< " -t Number of OCR threads for the text pieces of one image (default 1)."
+				<< endl;
+		cout
+				<< " -p Pipeline mode for directories, every step runs on its own threads (-j per heavy step)."
+				<< endl;
+		cout
+				<< " -a Debug image policy: none, sample:N (1 in N images) or all (default)."
+				<< endl;
+		cout
+				<< " -T Write the stage timings (JSON) to the given file at exit, not with -S."
+				<< endl;
+		cout
+				<< " -S Server mode, serve requests on the given Unix socket path with -j workers."
+				<< endl;
+		cout
+				<< " -C Client mode, send -i (-s or -d) to the server at the given Unix socket path."
+				<< endl;
 
 	}
 
@@ -73,10 +109,16 @@ public:
 		string ocrOutput;
 		string configPath;
 		string lang = "eng";
+		int threads = 1;
+		int ocrThreads = 1;
+		bool pipelineMode = false;
+		string serverSocket;
+		string clientSocket;
+		string timingPath;
 
 		cout << "Read parameters..." << endl;
 
-		while ((oc = getopt(argc, argv, "sdi:o:c:l:")) != -1) {
+		while ((oc = getopt(argc, argv, "sdi:o:c:l:j:t:pa:T:S:C:")) != -1) {
 			switch (oc) {
 			case 's':
 				printf("Single mode.\n");
@@ -102,6 +144,39 @@ public:
 				printf("Config file path is %s\n", optarg);
 				configPath = optarg;
 				break;
+			case 'j':
+				threads = atoi(optarg);
+				if (threads < 1)
+					threads = 1;
+				printf("Worker threads: %d\n", threads);
+				break;
+			case 'p':
+				printf("Pipeline mode.\n");
+				pipelineMode = true;
+				break;
+			case 'a':
+				printf("Artifact policy is %s\n", optarg);
+				if (!ArtifactWriter::instance().setPolicy(optarg))
+					return;
+				break;
+			case 'T':
+				printf("Stage timings go to %s\n", optarg);
+				timingPath = optarg;
+				break;
+			case 'S':
+				printf("Server socket is %s\n", optarg);
+				serverSocket = optarg;
+				break;
+			case 'C':
+				printf("Client of server socket %s\n", optarg);
+				clientSocket = optarg;
+				break;
+			case 't':
+				ocrThreads = atoi(optarg);
+				if (ocrThreads < 1)
+					ocrThreads = 1;
+				printf("OCR threads: %d\n", ocrThreads);
+				break;
 			case '?':
 				ec = (char) optopt;
 				printf("Invalid option \' %c \'!\n", ec);
@@ -111,6 +186,20 @@ public:
 				break;
 			}
 		}
+		if (!serverSocket.empty()) {
+			/*the server never exits, its timings are read with STATS*/
+			if (!timingPath.empty()) {
+				cerr << "-T can't be used with -S, send STATS to the server"
+						<< endl;
+				return;
+			}
+			serve(serverSocket, threads, ocrThreads, lang);
+			return;
+		}
+		if (!clientSocket.empty() && !input.empty()) {
+			client(clientSocket, input, singleMode, ocrOutput, lang, threads);
+			return;
+		}
 		if (input.empty() && configPath.empty()) {
 			usage();
 			return;
@@ -126,78 +215,72 @@ public:
 			if (!ocrOutput.empty()) {
 				string textPath = ocrOutput + "/"
 						+ FileUtil::getFileNameNoSuffix(input) + ".txt";
-//				time_t t1 = time(NULL);
 				cout << "OCR to: " << textPath << endl;
 
-				string text = ocrMats(dsts, lang);
-//				time_t t2 = time(NULL);
-//				time4+=(t2-t1);
+				string text = ocrMats(dsts, lang, ocrThreads);
 				FileUtil::writeToFile(text, textPath);
 			}
 		} else {
-			if (!input.empty()) {
-
-				vector<string> files = FileUtil::getAllFiles(input);
-				for (int i = 0; i < files.size(); i++) {
-					vector<Mat> mats = processFile(input + "/" + files[i],
-							config);
-					if (!ocrOutput.empty()) {
-
-//						time_t t1 = time(NULL);
-						string text = ocrMats(mats, lang);
-//						time_t t2 = time(NULL);
-//						time4+=(t2-t1);
-						string textPath = ocrOutput + "/"
-								+ FileUtil::getFileNameNoSuffix(files[i])
-								+ ".txt";
-
-						FileUtil::writeToFile(text, textPath);
-					}
-				}
+			if (!input.empty() && pipelineMode) {
+				processDirPipeline(input, config, ocrOutput, lang, threads,
+						ocrThreads);
+			} else if (!input.empty()) {
+				processDir(input, config, ocrOutput, lang, threads,
+						ocrThreads);
 			}
 		}
-		/*
-		 cout<<"Aver. Salient&Border: "<<(0.0+time1)/nopic<<endl;
-		 cout<<" -Aver. Salient: "<<(0.0+time01)/nopic<<endl;
-		 cout<<" -Aver. Border: "<<(0.0+time02)/nopic<<endl;
-		 cout<<"Aver. Text Detection: "<<(0.0+time2)/nopic<<endl;
-		 cout<<"Aver. Pre-processing: "<<(0.0+time3)/nopic<<endl;
-
-		 cout<<"Aver. Text OCR Procs: "<<(0.0+time4)/nopic<<endl;
-		 */
+		ArtifactWriter::instance().flush();
+		if (!timingPath.empty())
+			StageStats::instance().dumpJson(timingPath);
 	}
 
 	//used in JNI
 	static vector<Mat> process_image_main(Mat& img) {
 
-		SalientRec src;
-		Mat outputSRC, seg, crossBD, outputBD;
+		SalientRecLease src;
+		vector<Point2f> corners;
+		return process_image_main(img, *src, corners);
+	}
+
+	/*
+	 * corners gets the card border in img coordinates (empty if not found).
+	 * src is only used by the calling thread.
+	 */
+	static vector<Mat> process_image_main(Mat& img, SalientRec& src,
+			vector<Point2f>& corners) {
+
+		SalientMap outputSRC;
+		Mat seg, crossBD, outputBD;
 
 		cout << "salient and border..." << endl;
-		long long int start = getSystemTime();
+		ScopedTimer salientTimer(SALIENT_STAGE);
 		src.salient(img, outputSRC, seg);
-		Mat outputFileSRC = convertToVisibleMat<float>(outputSRC);
+		salientTimer.stop();
 
-		int res = getBorderImgOnSalient(img, outputSRC, crossBD, outputBD);
+		ScopedTimer borderTimer(BORDER_STAGE);
+		BorderContext border;
+		int res = getBorderImgOnSalient(border, img, outputSRC, crossBD,
+				outputBD, corners);
 		if (res == -1) {
-			res = getBorderImgOnRaw(img, outputSRC, crossBD, outputBD);
+			corners.clear();
+			res = getBorderImgOnRaw(border, img, outputSRC, crossBD, outputBD,
+					corners);
 		}
 
 		normalize(outputBD, outputBD, 0, 255, NORM_MINMAX);
 		outputBD.convertTo(outputBD, CV_8UC1);
-
-		long long int end = getSystemTime();
-		printf("salient and border time: %lld ms\n", end - start);
+		borderTimer.stop();
 
 		cout << "text detection..." << endl;
-		start = getSystemTime();
+		ScopedTimer textTimer(TEXT_STAGE);
 		vector<Mat> textPieces;
+		unique_lock<mutex> textLock(textMutex());
 		textDetect(outputBD, textPieces, res == -1 ? false : true);
-		end = getSystemTime();
-		printf("text detection time: %lld ms\n", end - start);
+		textLock.unlock();
+		textTimer.stop();
 
 		cout << "Preprocessing..." << endl;
-		start = getSystemTime();
+		ScopedTimer preprocessTimer(PREPROCESS_STAGE);
 		for (unsigned int i = 0; i < textPieces.size(); i++) {
 			cvtColor(textPieces[i], textPieces[i], COLOR_BGR2GRAY);
 		}
@@ -205,8 +288,6 @@ public:
 		Binarize::binarizeSet(textPieces, textPieces);
 		Denoise::denoiseSet(textPieces, textPieces);
 		Deskew::deskewSet(textPieces, textPieces);
-		end = getSystemTime();
-		printf("Preprocessing time: %lld ms\n", end - start);
 
 		return textPieces;
 
@@ -219,6 +300,22 @@ public:
 		dst = merge(mats);
 	}
 
+	//used in JNI
+	static string process_image_ocr(Mat& img, string lang, int ocrThreads) {
+
+		vector<Mat> mats = process_image_main(img);
+		cout << "OCR..." << endl;
+		return ocrMats(mats, lang, ocrThreads);
+	}
+
+	/*
+	 * Long running server and its client, defined in server.h.
+	 */
+	static int serve(string socketPath, int workers, int ocrThreads,
+			string lang);
+	static int client(string socketPath, string input, bool singleMode,
+			string ocrOutput, string lang, int threads);
+
 	static string ocrMat(Mat& mat) {
 		ostringstream os;
 		os << OCRUtil::ocrFile(mat, lang) << endl;
@@ -233,9 +330,68 @@ public:
 		return os.str();
 	}
 
+	/*
+	 * OCRs the pieces on up to threads threads, each holding its own engine.
+	 * The text is joined in the order of mats, same as the serial version.
+	 */
+	static string ocrMats(vector<Mat>& mats, string lang, int threads) {
+		static StageId stage("ocr");
+		ScopedTimer timer(stage);
+		if (threads > (int) mats.size())
+			threads = mats.size();
+		if (threads <= 1)
+			return ocrMats(mats, lang);
+
+		if (OCREnginePool::instance().getMaxSize() < threads) {
+			OCREnginePool::instance().setMaxSize(threads);
+		}
+		vector<string> texts(mats.size());
+		atomic<unsigned int> next(0);
+		vector<thread> workers;
+		for (int i = 1; i < threads; i++) {
+			workers.push_back(
+					thread(ocrPieces, ref(mats), cref(lang), ref(texts),
+							ref(next)));
+		}
+		ocrPieces(mats, lang, texts, next);
+		for (unsigned int i = 0; i < workers.size(); i++) {
+			workers[i].join();
+		}
+
+		ostringstream os;
+		for (unsigned i = 0; i < texts.size(); i++) {
+			os << texts[i] << endl;
+		}
+		return os.str();
+	}
+
+	static void ocrPieces(vector<Mat>& mats, const string& lang,
+			vector<string>& texts, atomic<unsigned int>& next) {
+		OCREngineLease tess(lang);
+		if (tess.get() == NULL)
+			return;
+		unsigned int i;
+		while ((i = next++) < mats.size()) {
+			texts[i] = OCRUtil::ocrFile(mats[i], tess.get());
+		}
+	}
+
 	static vector<Mat> processFile(string input, const Config conf) {
+		SalientRecLease src;
+		return processFile(input, conf, *src);
+	}
+
+	/*
+	 * src is only used by the calling thread, the text detection step is
+	 * serialized by textMutex().
+	 */
+	static vector<Mat> processFile(string input, const Config conf,
+			SalientRec& src) {
 		Config config = conf;
+		ScopedTimer imageTimer(IMAGE_STAGE);
+		ScopedTimer decodeTimer(DECODE_STAGE);
 		Mat img = imread(input);
+		decodeTimer.stop();
 		cout << "Process " << input << endl;
 		string salientOut = config.getAndErase(SALIENT);
 		string borderOut = config.getAndErase(BORDER);
@@ -249,20 +405,55 @@ public:
 			return ret;
 		}
 
-		SalientRec src;
-		Mat outputSRC, seg, crossBD, outputBD;
+		bool artifacts = ArtifactWriter::instance().sampleImage();
+		SalientMap outputSRC;
+		Mat outputBD;
+		salientStep(input, img, src, salientOut, outputSRC, artifacts);
+		int res = borderStep(input, img, outputSRC, borderOut, turnOut,
+				outputBD, artifacts);
+		vector<Mat> textPieces;
+		textStep(input, outputBD, res, textOut, textPieces, artifacts);
+		preprocessStep(input, config, textPieces, artifacts);
+
+		return textPieces;
+	}
+
+	/*
+	 * The *Step functions write their debug images through ArtifactWriter
+	 * if artifacts is true. outputSRC stays at the resolution the saliency
+	 * is computed on, it is only upsampled for the artifact.
+	 */
+	static void salientStep(const string& input, Mat& img, SalientRec& src,
+			const string& salientOut, SalientMap& outputSRC, bool artifacts) {
+		ScopedTimer timer(SALIENT_STAGE);
+		Mat seg;
 
 		cout << "salient object..." << endl;
 
 		src.salient(img, outputSRC, seg);
-		Mat outputFileSRC = convertToVisibleMat<float>(outputSRC);
+		if (!artifacts)
+			return;
+		Mat fullSRC = outputSRC.full();
+		Mat outputFileSRC = convertToVisibleMat<float>(fullSRC);
 
 		string salientOutPath = salientOut + "/" + FileUtil::getFileName(input);
-		imwrite(salientOutPath, outputFileSRC);
+		ArtifactWriter::instance().write(salientOutPath, outputFileSRC);
+	}
 
-		int res = getBorderImgOnSalient(img, outputSRC, crossBD, outputBD);
+	/*
+	 * Returns -1 if no border was found on the salient image.
+	 */
+	static int borderStep(const string& input, Mat& img, SalientMap& outputSRC,
+			const string& borderOut, const string& turnOut, Mat& outputBD,
+			bool artifacts) {
+		ScopedTimer timer(BORDER_STAGE);
+		Mat crossBD;
+
+		BorderContext border;
+		int res = getBorderImgOnSalient(border, img, outputSRC, crossBD,
+				outputBD);
 		if (res == -1) {
-			res = getBorderImgOnRaw(img, outputSRC, crossBD, outputBD);
+			res = getBorderImgOnRaw(border, img, outputSRC, crossBD, outputBD);
 		}
 
 		normalize(outputBD, outputBD, 0, 255, NORM_MINMAX);
@@ -271,16 +462,32 @@ public:
 		string borderOutPath = borderOut + "/" + FileUtil::getFileName(input);
 		string turnOutPath = turnOut + "/" + FileUtil::getFileName(input);
 
-		imwrite(borderOutPath, crossBD);
-		imwrite(turnOutPath, outputBD);
+		if (artifacts) {
+			ArtifactWriter::instance().write(borderOutPath, crossBD);
+			ArtifactWriter::instance().write(turnOutPath, outputBD.clone());
+		}
+		return res;
+	}
 
-		vector<Mat> textPieces;
+	static void textStep(const string& input, Mat& outputBD, int res,
+			const string& textOut, vector<Mat>& textPieces, bool artifacts) {
+		ScopedTimer timer(TEXT_STAGE);
+		unique_lock<mutex> textLock(textMutex());
 		textDetect(outputBD, textPieces, res == -1 ? false : true);
+		textLock.unlock();
 
 		string textPath = textOut + "/" + FileUtil::getFileName(input);
 
-		imwrite(textPath, merge(textPieces));
+		if (artifacts)
+			ArtifactWriter::instance().write(textPath, merge(textPieces));
+	}
 
+	/*
+	 * config holds only the preprocessing steps (method = directory).
+	 */
+	static void preprocessStep(const string& input, Config& config,
+			vector<Mat>& textPieces, bool artifacts) {
+		ScopedTimer timer(PREPROCESS_STAGE);
 		cout << "Preprocessing..." << endl;
 
 		for (unsigned int i = 0; i < textPieces.size(); i++) {
@@ -294,13 +501,13 @@ public:
 
 			string outputPath = step.second + "/"
 					+ FileUtil::getFileName(input);
-			cout<<"outputpath:" + outputPath<<endl;
 			process(textPieces, cur);
-			imwrite(outputPath, merge(cur));
+			if (artifacts) {
+				cout<<"outputpath:" + outputPath<<endl;
+				ArtifactWriter::instance().write(outputPath, merge(cur));
+			}
 			textPieces = cur;
 		}
-
-		return textPieces;
 	}
 	static Mat merge(vector<Mat>& mats) {
 		int width = maxWidth(mats);
@@ -335,6 +542,144 @@ public:
 			vector<Mat> mats = processFile(input + "/" + files[i], conf);
 		}
 	}
+
+	/*
+	 * Processes (and OCRs, if ocrOutput is not empty) all files of input with
+	 * threads workers. Each file leases a SalientRec and OCR engines from
+	 * their pools, the output paths are the same as in the serial mode.
+	 */
+	static void processDir(string input, const Config conf, string ocrOutput,
+			string lang, int threads, int ocrThreads) {
+		vector<string> files = FileUtil::getAllFiles(input);
+		WorkStealingPool pool(threads);
+		if (OCREnginePool::instance().getMaxSize() < pool.size() * ocrThreads) {
+			OCREnginePool::instance().setMaxSize(pool.size() * ocrThreads);
+		}
+		for (unsigned int i = 0; i < files.size(); i++) {
+			pool.submit(
+					bind(processDirFile, input, files[i], cref(conf),
+							ocrOutput, lang, ocrThreads));
+		}
+		pool.run();
+	}
+
+	static void processDirFile(const string& input, const string& file,
+			const Config& conf, const string& ocrOutput, const string& lang,
+			int ocrThreads) {
+		vector<Mat> mats = processFile(input + "/" + file, conf);
+		if (!ocrOutput.empty()) {
+			string text = ocrMats(mats, lang, ocrThreads);
+			string textPath = ocrOutput + "/"
+					+ FileUtil::getFileNameNoSuffix(file) + ".txt";
+
+			FileUtil::writeToFile(text, textPath);
+		}
+	}
+
+	/*
+	 * Same output as processDir, but as a pipeline:
+	 * decode -> salient -> border -> text -> preprocess -> OCR.
+	 * Salient, border, preprocess and OCR get threads threads each, decode
+	 * one. Text gets one thread, it is serialized by textMutex() anyway.
+	 * The queue depths are printed every second.
+	 */
+	static void processDirPipeline(string input, const Config conf,
+			string ocrOutput, string lang, int threads, int ocrThreads) {
+		Config config = conf;
+		string salientOut = config.getAndErase(SALIENT);
+		string borderOut = config.getAndErase(BORDER);
+		string turnOut = config.getAndErase(TURN);
+		string textOut = config.getAndErase(TEXT);
+		if (salientOut.empty() || borderOut.empty()) {
+			cerr
+					<< "salient output or border output is empty. (in config file)!"
+					<< endl;
+			return;
+		}
+
+		vector<string> files = FileUtil::getAllFiles(input);
+		if (threads < 1)
+			threads = 1;
+		if (OCREnginePool::instance().getMaxSize() < threads * ocrThreads) {
+			OCREnginePool::instance().setMaxSize(threads * ocrThreads);
+		}
+
+		Pipeline pipeline(2 * threads);
+		pipeline.addStage("decode", 1, decodeStage);
+		pipeline.addStage("salient", threads,
+				bind(salientStage, placeholders::_1, salientOut));
+		pipeline.addStage("border", threads,
+				bind(borderStage, placeholders::_1, borderOut, turnOut));
+		pipeline.addStage("text", 1,
+				bind(textStage, placeholders::_1, textOut));
+		pipeline.addStage("preprocess", threads,
+				bind(preprocessStage, placeholders::_1, config));
+		if (!ocrOutput.empty()) {
+			pipeline.addStage("ocr", threads,
+					bind(ocrStage, placeholders::_1, ocrOutput, lang,
+							ocrThreads));
+		}
+
+		pipeline.start(1000);
+		for (unsigned int i = 0; i < files.size(); i++) {
+			pipeline.push(new ImageJob(input + "/" + files[i], files[i]));
+		}
+		pipeline.finish();
+		pipeline.printMaxQueueDepths(cout);
+	}
+
+	static void decodeStage(ImageJob& job, int) {
+		ScopedTimer timer(DECODE_STAGE);
+		job.img = imread(job.input);
+		job.artifacts = ArtifactWriter::instance().sampleImage();
+		cout << "Process " << job.input << endl;
+		if (job.img.empty()) {
+			cerr << "Can't read " << job.input << endl;
+			job.failed = true;
+		}
+	}
+
+	static void salientStage(ImageJob& job, const string& salientOut) {
+		SalientRecLease src;
+		salientStep(job.input, job.img, *src, salientOut, job.outputSRC,
+				job.artifacts);
+	}
+
+	static void borderStage(ImageJob& job, const string& borderOut,
+			const string& turnOut) {
+		job.res = borderStep(job.input, job.img, job.outputSRC, borderOut,
+				turnOut, job.outputBD, job.artifacts);
+		job.img.release();
+		job.outputSRC.release();
+	}
+
+	static void textStage(ImageJob& job, const string& textOut) {
+		textStep(job.input, job.outputBD, job.res, textOut, job.textPieces,
+				job.artifacts);
+		job.outputBD.release();
+	}
+
+	static void preprocessStage(ImageJob& job, Config& config) {
+		preprocessStep(job.input, config, job.textPieces, job.artifacts);
+	}
+
+	static void ocrStage(ImageJob& job, const string& ocrOutput,
+			const string& lang, int ocrThreads) {
+		string text = ocrMats(job.textPieces, lang, ocrThreads);
+		string textPath = ocrOutput + "/"
+				+ FileUtil::getFileNameNoSuffix(job.name) + ".txt";
+
+		FileUtil::writeToFile(text, textPath);
+	}
+
+	/*
+	 * Text detection keeps its state in globals, so only one thread may
+	 * run it at a time. Border position keeps it in a BorderContext.
+	 */
+	static mutex& textMutex() {
+		static mutex m;
+		return m;
+	}
 	static void (*getMethod(string methodName))(vector<Mat>&, vector<Mat>&)
 			{
 				if (methodName == BINARIZE) {
@@ -360,6 +705,15 @@ public:
 		const string Processor::DESKEW = "deskew";
 		const string Processor::CCA = "cca";
 
+		const StageId Processor::IMAGE_STAGE("image");
+		const StageId Processor::DECODE_STAGE("decode");
+		const StageId Processor::SALIENT_STAGE("salient");
+		const StageId Processor::BORDER_STAGE("border");
+		const StageId Processor::TEXT_STAGE("text");
+		const StageId Processor::PREPROCESS_STAGE("preprocess");
+
 		string Processor::lang = "eng";
 
+#include "server.h"
+
 #endif /* IMAGE_PROCESS_SRC_WORKFLOW_PROCESSOR_H_ */
@@ -0,0 +1,476 @@
+/*
+ * server.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: xxy
+ */
+
+#ifndef IMAGE_PROCESS_SRC_WORKFLOW_SERVER_H_
+#define IMAGE_PROCESS_SRC_WORKFLOW_SERVER_H_
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "processor.h"
+#include "../util/boundedQueue.h"
+#include "../util/workStealingPool.h"
+#include "../util/stageTimer.h"
+
+using namespace std;
+using namespace cv;
+
+/*
+ * Long running mode: the segmenters of SalientRec and the OCR engines are
+ * created once and serve every request.
+ *
+ * Protocol over a Unix domain socket, any number of requests per connection:
+ *   OCR <lang> PATH <image path>\n
+ *   OCR <lang> BYTES <n>\n followed by n bytes of an encoded image (jpg, png...)
+ *   PING\n
+ *   STATS\n
+ * <lang> is a tesseract language string, "-" means the server default.
+ * Responses:
+ *   OK <k> <x1> <y1> ... <xk> <yk> <n>\n followed by n bytes of UTF-8 text
+ *     (the k corners of the card border in image pixels, k is 0 if no
+ *     border was found)
+ *   OK <n>\n followed by n bytes of stage timing JSON (for STATS, see
+ *     stageTimer.h)
+ *   ERR <message>\n
+ * A connection is closed after IDLE_SECONDS without a byte from the client.
+ * The server runs until it is killed, STATS is the way to get its timings.
+ */
+
+/*
+ * Buffered line/byte reading and writing on a socket.
+ */
+class SocketStream {
+public:
+	SocketStream(int fd) :
+			fd(fd), pos(0), len(0) {
+	}
+
+	bool readLine(string& line) {
+		line.clear();
+		char c;
+		while (readByte(c)) {
+			if (c == '\n')
+				return true;
+			if (c != '\r')
+				line += c;
+		}
+		return false;
+	}
+
+	bool readBytes(size_t n, vector<uchar>& data) {
+		data.resize(n);
+		for (size_t i = 0; i < n; i++) {
+			char c;
+			if (!readByte(c))
+				return false;
+			data[i] = (uchar) c;
+		}
+		return true;
+	}
+
+	bool writeAll(const string& data) {
+		size_t sent = 0;
+		while (sent < data.size()) {
+			ssize_t n = send(fd, data.data() + sent, data.size() - sent,
+					MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			sent += n;
+		}
+		return true;
+	}
+
+private:
+	bool readByte(char& c) {
+		if (pos == len) {
+			ssize_t n;
+			do {
+				n = recv(fd, buffer, sizeof(buffer), 0);
+			} while (n < 0 && errno == EINTR);
+			if (n <= 0)
+				return false;
+			pos = 0;
+			len = n;
+		}
+		c = buffer[pos++];
+		return true;
+	}
+
+	int fd;
+	char buffer[4096];
+	size_t pos;
+	size_t len;
+};
+
+class OCRServer {
+public:
+	/*
+	 * Images larger than this are refused.
+	 */
+	const static size_t MAX_IMAGE_BYTES = 64 * 1024 * 1024;
+	/*
+	 * A connection silent for this long is closed, so an idle client does
+	 * not hold a worker and its SalientRec.
+	 */
+	const static int IDLE_SECONDS = 30;
+
+	OCRServer(const string& socketPath, int workers, int ocrThreads,
+			const string& lang) :
+			socketPath(socketPath), workers(workers < 1 ? 1 : workers), ocrThreads(
+					ocrThreads < 1 ? 1 : ocrThreads), lang(lang), connections(
+					2 * this->workers) {
+	}
+
+	/*
+	 * Serves until the process is killed. Returns -1 if the socket can't
+	 * be opened.
+	 */
+	int run() {
+		int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listenFd < 0) {
+			cerr << "Can't create socket: " << strerror(errno) << endl;
+			return -1;
+		}
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if (socketPath.size() >= sizeof(addr.sun_path)) {
+			cerr << "Socket path is too long: " << socketPath << endl;
+			close(listenFd);
+			return -1;
+		}
+		strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+		unlink(socketPath.c_str());
+		if (::bind(listenFd, (struct sockaddr*) &addr, sizeof(addr)) < 0
+				|| listen(listenFd, 64) < 0) {
+			cerr << "Can't listen on " << socketPath << ": " << strerror(errno)
+					<< endl;
+			close(listenFd);
+			return -1;
+		}
+		signal(SIGPIPE, SIG_IGN);
+
+		cout << "Loading models..." << endl;
+		if (OCREnginePool::instance().getMaxSize() < workers * ocrThreads) {
+			OCREnginePool::instance().setMaxSize(workers * ocrThreads);
+		}
+		OCREnginePool::instance().warmUp(lang, workers * ocrThreads);
+
+		vector<thread> threads;
+		for (int i = 0; i < workers; i++) {
+			threads.push_back(
+					thread(&OCRServer::serveConnections, this));
+		}
+		cout << "Serving on " << socketPath << " with " << workers
+				<< " workers" << endl;
+
+		while (true) {
+			int fd = accept(listenFd, NULL, NULL);
+			if (fd < 0) {
+				if (errno == EINTR || errno == ECONNABORTED)
+					continue;
+				cerr << "accept failed: " << strerror(errno) << endl;
+				break;
+			}
+			struct timeval timeout;
+			timeout.tv_sec = IDLE_SECONDS;
+			timeout.tv_usec = 0;
+			setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			connections.push(fd);
+		}
+
+		connections.close();
+		for (unsigned int i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+		close(listenFd);
+		unlink(socketPath.c_str());
+		return 0;
+	}
+
+private:
+	/*
+	 * Every worker holds one SalientRec of the pool while the server runs.
+	 */
+	void serveConnections() {
+		SalientRecLease src;
+		int fd;
+		while (connections.pop(fd)) {
+			SocketStream stream(fd);
+			string line;
+			while (stream.readLine(line)) {
+				if (!line.empty() && !handle(line, stream, *src))
+					break;
+			}
+			close(fd);
+		}
+	}
+
+	/*
+	 * Returns false if the connection should be closed.
+	 */
+	bool handle(const string& line, SocketStream& stream, SalientRec& src) {
+		istringstream is(line);
+		string command, reqLang, kind;
+		is >> command;
+		if (command == "PING") {
+			return stream.writeAll("OK\n");
+		}
+		if (command == "STATS") {
+			string json = StageStats::instance().toJson();
+			ostringstream os;
+			os << "OK " << json.size() << "\n" << json;
+			return stream.writeAll(os.str());
+		}
+		if (command != "OCR") {
+			return stream.writeAll("ERR unknown command\n");
+		}
+		is >> reqLang >> kind;
+		if (reqLang.empty() || reqLang == "-")
+			reqLang = lang;
+
+		Mat img;
+		if (kind == "PATH") {
+			string path;
+			getline(is >> ws, path);
+			img = imread(path);
+			if (img.empty())
+				return stream.writeAll("ERR can't read " + path + "\n");
+		} else if (kind == "BYTES") {
+			long long n = -1;
+			is >> n;
+			if (n < 0 || (size_t) n > MAX_IMAGE_BYTES) {
+				/*the image bytes can't be skipped, drop the connection*/
+				stream.writeAll("ERR bad image size\n");
+				return false;
+			}
+			vector<uchar> data;
+			if (!stream.readBytes(n, data))
+				return false;
+			img = imdecode(data, IMREAD_COLOR);
+			if (img.empty())
+				return stream.writeAll("ERR can't decode image\n");
+		} else {
+			return stream.writeAll("ERR expected PATH or BYTES\n");
+		}
+		/*checked once per language, tesseract is not initialized again*/
+		if (!OCREnginePool::instance().available(reqLang))
+			return stream.writeAll("ERR unknown language\n");
+
+		vector<Point2f> corners;
+		string text;
+		try {
+			vector<Mat> pieces = Processor::process_image_main(img, src,
+					corners);
+			text = Processor::ocrMats(pieces, reqLang, ocrThreads);
+		} catch (exception& e) {
+			/*cv::Exception, and out_of_range or bad_alloc of the border code*/
+			string msg = e.what();
+			replace(msg.begin(), msg.end(), '\n', ' ');
+			return stream.writeAll("ERR " + msg + "\n");
+		} catch (...) {
+			return stream.writeAll("ERR unexpected failure\n");
+		}
+
+		ostringstream os;
+		os << "OK " << corners.size();
+		for (unsigned int i = 0; i < corners.size(); i++) {
+			os << " " << corners[i].x << " " << corners[i].y;
+		}
+		os << " " << text.size() << "\n" << text;
+		return stream.writeAll(os.str());
+	}
+
+	string socketPath;
+	int workers;
+	int ocrThreads;
+	string lang;
+	BoundedQueue<int> connections;
+};
+
+/*
+ * Client side of the protocol, also used to exercise a running server.
+ */
+class OCRClient {
+public:
+	/*
+	 * Sends the image file at path as BYTES. Returns 0 and fills corners
+	 * and text on OK, otherwise -1 with the error in text.
+	 */
+	static int request(const string& socketPath, const string& path,
+			const string& lang, vector<Point2f>& corners, string& text) {
+		ifstream in(path.c_str(), ios::binary);
+		if (!in) {
+			text = "can't read " + path;
+			return -1;
+		}
+		string data((istreambuf_iterator<char>(in)),
+				istreambuf_iterator<char>());
+
+		int fd = connectTo(socketPath);
+		if (fd < 0) {
+			text = "can't connect to " + socketPath;
+			return -1;
+		}
+		SocketStream stream(fd);
+		ostringstream req;
+		req << "OCR " << (lang.empty() ? "-" : lang) << " BYTES " << data.size()
+				<< "\n";
+		int ret = -1;
+		string line;
+		if (!stream.writeAll(req.str() + data) || !stream.readLine(line)) {
+			text = "connection closed";
+		} else if (line.compare(0, 3, "OK ") == 0) {
+			istringstream is(line.substr(3));
+			size_t k = 0, n = 0;
+			is >> k;
+			for (size_t i = 0; i < k; i++) {
+				Point2f p;
+				is >> p.x >> p.y;
+				corners.push_back(p);
+			}
+			is >> n;
+			vector<uchar> bytes;
+			if (stream.readBytes(n, bytes)) {
+				text = string(bytes.begin(), bytes.end());
+				ret = 0;
+			} else {
+				text = "connection closed";
+			}
+		} else {
+			text = line.compare(0, 4, "ERR ") == 0 ? line.substr(4) : line;
+		}
+		close(fd);
+		return ret;
+	}
+
+	/*
+	 * Fetches the server's stage timing JSON. Returns -1 on failure.
+	 */
+	static int stats(const string& socketPath, string& json) {
+		int fd = connectTo(socketPath);
+		if (fd < 0)
+			return -1;
+		SocketStream stream(fd);
+		string line;
+		int ret = -1;
+		if (stream.writeAll("STATS\n") && stream.readLine(line)
+				&& line.compare(0, 3, "OK ") == 0) {
+			vector<uchar> bytes;
+			if (stream.readBytes(atol(line.c_str() + 3), bytes)) {
+				json = string(bytes.begin(), bytes.end());
+				ret = 0;
+			}
+		}
+		close(fd);
+		return ret;
+	}
+
+	/*
+	 * Sends input (a file, or every file of a directory with threads
+	 * concurrent connections) and prints the corners of each response. The
+	 * text goes to ocrOutput/<name>.txt if ocrOutput is not empty.
+	 * Prints the server's stage timings at the end.
+	 * Returns the number of failed requests.
+	 */
+	static int run(const string& socketPath, const string& input,
+			bool singleMode, const string& ocrOutput, const string& lang,
+			int threads) {
+		vector<string> paths;
+		if (singleMode) {
+			paths.push_back(input);
+		} else {
+			vector<string> files = FileUtil::getAllFiles(input);
+			for (unsigned int i = 0; i < files.size(); i++) {
+				paths.push_back(input + "/" + files[i]);
+			}
+		}
+
+		atomic<int> failed(0);
+		mutex outMtx;
+		long long int start = getSystemTime();
+		WorkStealingPool pool(threads);
+		for (unsigned int i = 0; i < paths.size(); i++) {
+			pool.submit(
+					bind(requestFile, cref(socketPath), paths[i], cref(ocrOutput),
+							cref(lang), ref(failed), ref(outMtx)));
+		}
+		pool.run();
+		long long int end = getSystemTime();
+		cout << paths.size() - failed << " ok, " << failed << " failed, "
+				<< end - start << " ms" << endl;
+		string json;
+		if (stats(socketPath, json) == 0)
+			cout << "server stage timings: " << json << endl;
+		return failed;
+	}
+
+private:
+	static void requestFile(const string& socketPath, const string& path,
+			const string& ocrOutput, const string& lang, atomic<int>& failed,
+			mutex& outMtx) {
+		vector<Point2f> corners;
+		string text;
+		int ret = request(socketPath, path, lang, corners, text);
+		lock_guard<mutex> lock(outMtx);
+		if (ret != 0) {
+			failed++;
+			cerr << path << ": ERR " << text << endl;
+			return;
+		}
+		cout << path << ": OK";
+		for (unsigned int i = 0; i < corners.size(); i++) {
+			cout << " (" << corners[i].x << "," << corners[i].y << ")";
+		}
+		cout << endl;
+		if (!ocrOutput.empty()) {
+			FileUtil::writeToFile(text,
+					ocrOutput + "/" + FileUtil::getFileNameNoSuffix(path)
+							+ ".txt");
+		} else {
+			cout << text << endl;
+		}
+	}
+
+	static int connectTo(const string& socketPath) {
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+		if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+			close(fd);
+			return -1;
+		}
+		return fd;
+	}
+};
+
+int Processor::serve(string socketPath, int workers, int ocrThreads,
+		string lang) {
+	OCRServer server(socketPath, workers, ocrThreads, lang);
+	return server.run();
+}
+
+int Processor::client(string socketPath, string input, bool singleMode,
+		string ocrOutput, string lang, int threads) {
+	return OCRClient::run(socketPath, input, singleMode, ocrOutput, lang,
+			threads);
+}
+
+#endif /* IMAGE_PROCESS_SRC_WORKFLOW_SERVER_H_ */